@@ -47,6 +47,10 @@ Real Castro::T_curr_max = 0.0;
 Real Castro::rho_curr_max = 0.0;
 Real Castro::ts_te_curr_max = 0.0;
 
+Real Castro::diag_sums[diag_nsum] = { 0.0 };
+Real Castro::diag_maxes[diag_nmax] = { 0.0 };
+Real Castro::diag_time = -1.0e200;
+
 Real Castro::total_ener_array[num_previous_ener_timesteps] = { 0.0 };
 
 #ifdef DO_PROBLEM_POST_TIMESTEP
@@ -124,155 +128,24 @@ Castro::wd_update (Real time, Real dt)
     Real old_mass_p = mass_p;
     Real old_mass_s = mass_s;
 
-    Real com_p_x = 0.0;
-    Real com_p_y = 0.0;
-    Real com_p_z = 0.0;
-    Real com_s_x = 0.0;
-    Real com_s_y = 0.0;
-    Real com_s_z = 0.0;
-    Real vel_p_x = 0.0;
-    Real vel_p_y = 0.0;
-    Real vel_p_z = 0.0;
-    Real vel_s_x = 0.0;
-    Real vel_s_y = 0.0;
-    Real vel_s_z = 0.0;
-    Real mp      = 0.0;
-    Real ms      = 0.0;
-
-    for (int lev = 0; lev <= parent->finestLevel(); lev++) {
-
-      ca_set_amr_info(lev, -1, -1, -1.0, -1.0);
-
-      Castro& c_lev = getLevel(lev);
-
-      const Real* dx = c_lev.geom.CellSize();
-
-      // Density and momenta
-
-      auto mfrho  = c_lev.derive("density",time,0);
-      auto mfxmom = c_lev.derive("xmom",time,0);
-      auto mfymom = c_lev.derive("ymom",time,0);
-      auto mfzmom = c_lev.derive("zmom",time,0);
-
-      // Masks for the primary and secondary
-
-      auto mfpmask = c_lev.derive("primarymask", time, 0);
-      auto mfsmask = c_lev.derive("secondarymask", time, 0);
-
-      BL_ASSERT(mfrho   != nullptr);
-      BL_ASSERT(mfxmom  != nullptr);
-      BL_ASSERT(mfymom  != nullptr);
-      BL_ASSERT(mfzmom  != nullptr);
-      BL_ASSERT(mfpmask != nullptr);
-      BL_ASSERT(mfsmask != nullptr);
-
-      if (lev < parent->finestLevel())
-      {
-          const MultiFab& mask = getLevel(lev+1).build_fine_mask();
-
-	  MultiFab::Multiply(*mfrho,   mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfxmom,  mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfymom,  mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfzmom,  mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfpmask, mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfsmask, mask, 0, 0, 1, 0);
-      }
-
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:com_p_x,com_p_y,com_p_z,com_s_x,com_s_y,com_s_z) \
-                     reduction(+:vel_p_x,vel_p_y,vel_p_z,vel_s_x,vel_s_y,vel_s_z) \
-                     reduction(+:mp, ms)
-#endif
-      for (MFIter mfi(*mfrho,true); mfi.isValid(); ++mfi) {
-          FArrayBox& fabrho   = (*mfrho )[mfi];
-	  FArrayBox& fabxmom  = (*mfxmom)[mfi];
-	  FArrayBox& fabymom  = (*mfymom)[mfi];
-	  FArrayBox& fabzmom  = (*mfzmom)[mfi];
-	  FArrayBox& fabpmask = (*mfpmask)[mfi];
-	  FArrayBox& fabsmask = (*mfsmask)[mfi];
-	  FArrayBox& vol      = c_lev.volume[mfi];
-
-	  const Box& box  = mfi.tilebox();
-	  const int* lo   = box.loVect();
-	  const int* hi   = box.hiVect();
-
-	  wdcom(BL_TO_FORTRAN_3D(fabrho),
-		BL_TO_FORTRAN_3D(fabxmom),
-		BL_TO_FORTRAN_3D(fabymom),
-		BL_TO_FORTRAN_3D(fabzmom),
-		BL_TO_FORTRAN_3D(fabpmask),
-		BL_TO_FORTRAN_3D(fabsmask),
-		BL_TO_FORTRAN_3D(vol),
-		ARLIM_3D(lo),ARLIM_3D(hi),
-		ZFILL(dx),&time,
-		&com_p_x, &com_p_y, &com_p_z,
-		&com_s_x, &com_s_y, &com_s_z,
-		&vel_p_x, &vel_p_y, &vel_p_z,
-		&vel_s_x, &vel_s_y, &vel_s_z,
-		&mp, &ms);
-	}
-
-    }
-
-    ca_set_amr_info(level, -1, -1, -1.0, -1.0);
-
-    com_p[0] = com_p_x;
-    com_p[1] = com_p_y;
-    com_p[2] = com_p_z;
-    com_s[0] = com_s_x;
-    com_s[1] = com_s_y;
-    com_s[2] = com_s_z;
-    vel_p[0] = vel_p_x;
-    vel_p[1] = vel_p_y;
-    vel_p[2] = vel_p_z;
-    vel_s[0] = vel_s_x;
-    vel_s[1] = vel_s_y;
-    vel_s[2] = vel_s_z;
-    mass_p   = mp;
-    mass_s   = ms;
-
-    bool local_flag = true;
-
-    // Compute effective radii of stars at various density cutoffs
+    // The masses, centers of mass, velocities and volumes all come out
+    // of the same pass as the rest of the diagnostics at this time.
 
-    for (int i = 0; i <= 6; ++i)
-        Castro::volInBoundary(time, vol_p[i], vol_s[i], pow(10.0,i), local_flag);
+    wd_diagnostics(time);
 
-    // Do all of the reductions.
-
-    const int nfoo_sum = 28;
-    Real foo_sum[nfoo_sum] = { 0.0 };
-
-    for (int i = 0; i <= 6; ++i) {
-      foo_sum[i  ] = vol_p[i];
-      foo_sum[i+7] = vol_s[i];
-    }
-
-    foo_sum[14] = mass_p;
-    foo_sum[15] = mass_s;
+    mass_p = diag_sums[0];
+    mass_s = diag_sums[1];
 
     for (int i = 0; i <= 2; ++i) {
-      foo_sum[i+16] = com_p[i];
-      foo_sum[i+19] = com_s[i];
-      foo_sum[i+22] = vel_p[i];
-      foo_sum[i+25] = vel_s[i];
+      com_p[i] = diag_sums[i+2];
+      com_s[i] = diag_sums[i+5];
+      vel_p[i] = diag_sums[i+8];
+      vel_s[i] = diag_sums[i+11];
     }
 
-    amrex::ParallelDescriptor::ReduceRealSum(foo_sum, nfoo_sum);
-
     for (int i = 0; i <= 6; ++i) {
-      vol_p[i] = foo_sum[i  ];
-      vol_s[i] = foo_sum[i+7];
-    }
-
-    mass_p = foo_sum[14];
-    mass_s = foo_sum[15];
-
-    for (int i = 0; i <= 2; ++i) {
-      com_p[i] = foo_sum[i+16];
-      com_s[i] = foo_sum[i+19];
-      vel_p[i] = foo_sum[i+22];
-      vel_s[i] = foo_sum[i+25];
+      vol_p[i] = diag_sums[i+14];
+      vol_s[i] = diag_sums[i+21];
     }
 
     // Compute effective WD radii
@@ -341,95 +214,109 @@ Castro::wd_update (Real time, Real dt)
 
 
 
-// This function uses the known center of mass of the two white dwarfs,
-// and given a density cutoff, computes the total volume of all zones
-// whose density is greater or equal to that density cutoff.
-// We also impose a distance requirement so that we only look
-// at zones that are within twice the original radius of the white dwarf.
+// This function makes one pass over the state on every level, and sums up
+// the masses, centers of mass and velocities of the white dwarfs, the
+// volumes of the stars above a range of density cutoffs, and the second
+// time derivative of the quadrupole moment, while also finding the
+// extrema. Zones covered by a finer level are left out of the sums.
+// The results are reduced over the processors and stored in diag_sums
+// and diag_maxes for the consumers at this time.
 
-void Castro::volInBoundary (Real time, Real& vol_p, Real& vol_s, Real rho_cutoff, bool local)
+void
+Castro::wd_diagnostics (Real time)
 {
-    BL_PROFILE("Castro::volInBoundary()");
+    BL_PROFILE("Castro::wd_diagnostics()");
 
     BL_ASSERT(level == 0);
 
-    vol_p = 0.0;
-    vol_s = 0.0;
+#if !(defined(SELF_GRAVITY) && defined(ROTATION))
+    amrex::Abort("Error: the wdmerger diagnostics require self-gravity and rotation.");
+#else
+    int finest_level = parent->finestLevel();
+
+    Real sums[diag_nsum] = { 0.0 };
+    Real maxes[diag_nmax] = { 0.0 };
 
-    for (int lev = 0; lev <= parent->finestLevel(); lev++) {
+    for (int lev = 0; lev <= finest_level; lev++) {
 
       ca_set_amr_info(lev, -1, -1, -1.0, -1.0);
 
       Castro& c_lev = getLevel(lev);
 
       const Real* dx = c_lev.geom.CellSize();
-      auto mf = c_lev.derive("density",time,0);
 
-      // Effective potentials of the primary and secondary
+      MultiFab& S_new  = c_lev.get_new_data(State_Type);
+      MultiFab& phirot = c_lev.get_new_data(PhiRot_Type);
+      MultiFab& grav   = c_lev.get_new_data(Gravity_Type);
 
-      auto mfpmask = c_lev.derive("primarymask", time, 0);
-      auto mfsmask = c_lev.derive("secondarymask", time, 0);
+      // The timescale ratio is only tracked on the finest level.
 
-      BL_ASSERT(mf      != nullptr);
-      BL_ASSERT(mfpmask != nullptr);
-      BL_ASSERT(mfsmask != nullptr);
+#ifdef REACTIONS
+      MultiFab& react  = c_lev.get_new_data(Reactions_Type);
+      const int do_ts_te = (lev == finest_level);
+#else
+      MultiFab& react  = S_new; // not read
+      const int do_ts_te = 0;
+#endif
 
-      if (lev < parent->finestLevel())
-      {
-	  const MultiFab& mask = c_lev.getLevel(lev+1).build_fine_mask();
-	  MultiFab::Multiply(*mf,      mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfpmask, mask, 0, 0, 1, 0);
-	  MultiFab::Multiply(*mfsmask, mask, 0, 0, 1, 0);
-      }
+      // The volume stands in for the mask on the finest level, where it is not read.
 
-      Real vp = 0.0;
-      Real vs = 0.0;
+      const int use_mask = (lev < finest_level);
+      const MultiFab& mask = use_mask ? getLevel(lev+1).build_fine_mask() : c_lev.volume;
 
 #ifdef _OPENMP
-#pragma omp parallel reduction(+:vp,vs)
+#pragma omp parallel
 #endif
-      for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi) {
-          FArrayBox& fab      = (*mf)[mfi];
-          FArrayBox& fabpmask = (*mfpmask)[mfi];
-          FArrayBox& fabsmask = (*mfsmask)[mfi];
-          FArrayBox& vol      = c_lev.volume[mfi];
-
-	  Real sp = 0.0;
-	  Real ss = 0.0;
-
-	  const Box& box  = mfi.tilebox();
-	  const int* lo   = box.loVect();
-	  const int* hi   = box.hiVect();
-
-	  ca_volumeindensityboundary(BL_TO_FORTRAN_3D(fab),
-		                     BL_TO_FORTRAN_3D(fabpmask),
-				     BL_TO_FORTRAN_3D(fabsmask),
-				     BL_TO_FORTRAN_3D(vol),
-				     ARLIM_3D(lo),ARLIM_3D(hi),
-				     ZFILL(dx),&sp,&ss,&rho_cutoff);
-	  vp += sp;
-	  vs += ss;
-      }
-
-      vol_p += vp;
-      vol_s += vs;
+      {
+	  Real priv_sums[diag_nsum] = { 0.0 };
+	  Real priv_maxes[diag_nmax] = { 0.0 };
 
-    }
+	  for (MFIter mfi(S_new, true); mfi.isValid(); ++mfi) {
 
-    if (!local) {
+	      const Box& box  = mfi.tilebox();
+	      const int* lo   = box.loVect();
+	      const int* hi   = box.hiVect();
 
-      const int nfoo = 2;
-      Real foo[nfoo] = {vol_p, vol_s};
+	      sum_wd_diagnostics(ARLIM_3D(lo), ARLIM_3D(hi),
+				 BL_TO_FORTRAN_3D(S_new[mfi]),
+				 BL_TO_FORTRAN_3D(phirot[mfi]),
+				 BL_TO_FORTRAN_3D(grav[mfi]),
+				 BL_TO_FORTRAN_3D(react[mfi]),
+				 BL_TO_FORTRAN_3D(c_lev.volume[mfi]),
+				 BL_TO_FORTRAN_3D(mask[mfi]),
+				 &use_mask, &do_ts_te,
+				 ZFILL(dx), &time,
+				 priv_sums, priv_maxes);
 
-      amrex::ParallelDescriptor::ReduceRealSum(foo, nfoo);
+	  }
 
-      vol_p = foo[0];
-      vol_s = foo[1];
+#ifdef _OPENMP
+#pragma omp critical (wd_diagnostics)
+#endif
+	  {
+	      for (int i = 0; i < diag_nsum; ++i)
+		  sums[i] += priv_sums[i];
+	      for (int i = 0; i < diag_nmax; ++i)
+		  maxes[i] = std::max(maxes[i], priv_maxes[i]);
+	  }
+      }
 
     }
 
     ca_set_amr_info(level, -1, -1, -1.0, -1.0);
 
+    amrex::ParallelDescriptor::ReduceRealSum(sums, diag_nsum);
+    amrex::ParallelDescriptor::ReduceRealMax(maxes, diag_nmax);
+
+    for (int i = 0; i < diag_nsum; ++i)
+	diag_sums[i] = sums[i];
+
+    for (int i = 0; i < diag_nmax; ++i)
+	diag_maxes[i] = maxes[i];
+
+    diag_time = time;
+#endif
+
 }
 
 
@@ -442,113 +329,25 @@ void
 Castro::gwstrain (Real time,
 		  Real& h_plus_1, Real& h_cross_1,
 		  Real& h_plus_2, Real& h_cross_2,
-		  Real& h_plus_3, Real& h_cross_3,
-		  bool local) {
+		  Real& h_plus_3, Real& h_cross_3) {
 
     BL_PROFILE("Castro::gwstrain()");
 
-    const Real* dx = geom.CellSize();
-
-    auto mfrho   = derive("density",time,0);
-    auto mfxmom  = derive("xmom",time,0);
-    auto mfymom  = derive("ymom",time,0);
-    auto mfzmom  = derive("zmom",time,0);
-    auto mfgravx = derive("grav_x",time,0);
-    auto mfgravy = derive("grav_y",time,0);
-    auto mfgravz = derive("grav_z",time,0);
-
-    BL_ASSERT(mfrho   != nullptr);
-    BL_ASSERT(mfxmom  != nullptr);
-    BL_ASSERT(mfymom  != nullptr);
-    BL_ASSERT(mfzmom  != nullptr);
-    BL_ASSERT(mfgravx != nullptr);
-    BL_ASSERT(mfgravy != nullptr);
-    BL_ASSERT(mfgravz != nullptr);
-
-    if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-
-	MultiFab::Multiply(*mfrho,   mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mfxmom,  mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mfymom,  mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mfzmom,  mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mfgravx, mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mfgravy, mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mfgravz, mask, 0, 0, 1, 0);
-    }
-
-    // Qtt stores the second time derivative of the quadrupole moment.
-    // We calculate it directly rather than computing the quadrupole moment
-    // and differentiating it in time, because the latter method is less accurate
+    // Qtt is the second time derivative of the quadrupole moment. It was
+    // calculated directly in wd_diagnostics rather than by differentiating
+    // the quadrupole moment in time, because the latter method is less accurate
     // and requires the state at other timesteps. See, e.g., Equation 5 of
-    // Loren-Aguilar et al. 2005.
-
-    // It is a 3x3 rank-2 tensor, but AMReX expects IntVect() to use BL_SPACEDIM
-    // dimensions, so we add a redundant third index in 3D.
-
-    Box bx( IntVect(D_DECL(0, 0, 0)), IntVect(D_DECL(2, 2, 0)) );
-
-    FArrayBox Qtt(bx);
-
-    Qtt.setVal(0.0);
+    // Loren-Aguilar et al. 2005. It is normally left over from the call in
+    // problem_post_timestep at this time, unless update_relaxation has
+    // changed the state since.
 
-#ifdef _OPENMP
-    int nthreads = omp_get_max_threads();
-    Array< std::unique_ptr<FArrayBox> > priv_Qtt(nthreads);
-    for (int i=0; i<nthreads; i++) {
-	priv_Qtt[i].reset(new FArrayBox(bx));
-    }
-#pragma omp parallel
-#endif
-    {
-#ifdef _OPENMP
-	int tid = omp_get_thread_num();
-	priv_Qtt[tid]->setVal(0.0);
-#endif
-	for (MFIter mfi(*mfrho,true); mfi.isValid(); ++mfi) {
-
-	    const Box& box  = mfi.tilebox();
-	    const int* lo   = box.loVect();
-	    const int* hi   = box.hiVect();
-
-	    quadrupole_tensor_double_dot(BL_TO_FORTRAN_3D((*mfrho)[mfi]),
-					 BL_TO_FORTRAN_3D((*mfxmom)[mfi]),
-					 BL_TO_FORTRAN_3D((*mfymom)[mfi]),
-					 BL_TO_FORTRAN_3D((*mfzmom)[mfi]),
-					 BL_TO_FORTRAN_3D((*mfgravx)[mfi]),
-					 BL_TO_FORTRAN_3D((*mfgravy)[mfi]),
-					 BL_TO_FORTRAN_3D((*mfgravz)[mfi]),
-					 BL_TO_FORTRAN_3D(volume[mfi]),
-					 ARLIM_3D(lo),ARLIM_3D(hi),ZFILL(dx),&time,
-#ifdef _OPENMP
-					 priv_Qtt[tid]->dataPtr());
-#else
-	                                 Qtt.dataPtr());
-#endif
-        }
-    }
+    if (diag_time != time)
+	wd_diagnostics(time);
 
-    // Do an OpenMP reduction on the tensor.
+    Real Qtt[9];
 
-#ifdef _OPENMP
-        int n = bx.numPts();
-	Real* p = Qtt.dataPtr();
-#pragma omp barrier
-#pragma omp for nowait
-	for (int i=0; i<n; ++i)
-	{
-	    for (int it=0; it<nthreads; it++) {
-		const Real* pq = priv_Qtt[it]->dataPtr();
-		p[i] += pq[i];
-	    }
-	}
-#endif
-
-    // Now, do a global reduce over all processes.
-
-    if (!local)
-	amrex::ParallelDescriptor::ReduceRealSum(Qtt.dataPtr(),bx.numPts());
+    for (int i = 0; i < 9; ++i)
+	Qtt[i] = diag_sums[28+i];
 
     // Now that we have the second time derivative of the quadrupole
     // tensor, we can calculate the transverse-trace gauge strain tensor.
@@ -556,7 +355,7 @@ Castro::gwstrain (Real time,
     gw_strain_tensor(&h_plus_1, &h_cross_1,
 		     &h_plus_2, &h_cross_2,
 		     &h_plus_3, &h_cross_3,
-		     Qtt.dataPtr(), &time);
+		     Qtt, &time);
 
 }
 
@@ -842,49 +641,15 @@ void Castro::check_to_stop(Real time) {
 
 void Castro::update_extrema(Real time) {
 
-    // Compute extrema
-
-    bool local_flag = true;
-
-    T_curr_max     = 0.0;
-    rho_curr_max   = 0.0;
-    ts_te_curr_max = 0.0;
+    // The extrema come out of the diagnostics pass in wd_update, unless
+    // update_relaxation has changed the state since.
 
-    int finest_level = parent->finestLevel();
-
-    for (int lev = 0; lev <= finest_level; lev++) {
+    if (diag_time != time)
+	wd_diagnostics(time);
 
-      MultiFab& S_new = parent->getLevel(lev).get_new_data(State_Type);
-
-      T_curr_max = std::max(T_curr_max, S_new.max(Temp, 0, local_flag));
-      rho_curr_max = std::max(rho_curr_max, S_new.max(Density, 0, local_flag));
-
-#ifdef REACTIONS
-      if (lev == finest_level) {
-
-        auto ts_te_MF = parent->getLevel(lev).derive("t_sound_t_enuc", time, 0);
-	ts_te_curr_max = std::max(ts_te_curr_max, ts_te_MF->max(0,0,local_flag));
-
-      }
-#endif
-
-    }
-
-    // Max reductions
-
-    const int nfoo_max = 3;
-
-    Real foo_max[3];
-
-    foo_max[0] = T_curr_max;
-    foo_max[1] = rho_curr_max;
-    foo_max[2] = ts_te_curr_max;
-
-    amrex::ParallelDescriptor::ReduceRealMax(foo_max, nfoo_max);
-
-    T_curr_max     = foo_max[0];
-    rho_curr_max   = foo_max[1];
-    ts_te_curr_max = foo_max[2];
+    T_curr_max     = diag_maxes[0];
+    rho_curr_max   = diag_maxes[1];
+    ts_te_curr_max = diag_maxes[2];
 
     T_global_max     = std::max(T_global_max, T_curr_max);
     rho_global_max   = std::max(rho_global_max, rho_curr_max);
@@ -923,8 +688,8 @@ Castro::update_relaxation(Real time, Real dt) {
 
 	rot_force[lev]->setVal(0.0);
 
-	MultiFab::Add(*rot_force[lev], *(getLevel(lev).old_sources[grav_src]), 0, 0, NUM_STATE, ng);
-        MultiFab::Add(*rot_force[lev], *(getLevel(lev).new_sources[grav_src]), 0, 0, NUM_STATE, ng);
+	MultiFab::Add(*rot_force[lev], *(getLevel(lev).old_sources[grav_src]), 0, 0, getLevel(lev).old_sources[grav_src]->nComp(), ng);
+        MultiFab::Add(*rot_force[lev], *(getLevel(lev).new_sources[grav_src]), 0, 0, getLevel(lev).new_sources[grav_src]->nComp(), ng);
 
 	MultiFab::Add(*rot_force[lev], getLevel(lev).hydro_source, 0, 0, NUM_STATE, ng);
 
@@ -1051,19 +816,27 @@ Castro::update_relaxation(Real time, Real dt) {
 
 	getLevel(lev).expand_state(Sb, old_time, ng);
 
-	MultiFab::Saxpy(S_new, -dt, *(getLevel(lev).old_sources[rot_src]), 0, 0, NUM_STATE, ng);
-	MultiFab::Saxpy(S_new, -dt, *(getLevel(lev).new_sources[rot_src]), 0, 0, NUM_STATE, ng);
+	MultiFab::Saxpy(S_new, -dt, *(getLevel(lev).old_sources[rot_src]), 0, 0, getLevel(lev).old_sources[rot_src]->nComp(), ng);
+	MultiFab::Saxpy(S_new, -dt, *(getLevel(lev).new_sources[rot_src]), 0, 0, getLevel(lev).new_sources[rot_src]->nComp(), ng);
 
 	getLevel(lev).construct_old_source(rot_src, old_time, dt);
 	getLevel(lev).construct_new_source(rot_src, new_time, dt);
 
-	MultiFab::Saxpy(S_new, dt, *(getLevel(lev).old_sources[rot_src]), 0, 0, NUM_STATE, ng);
-	MultiFab::Saxpy(S_new, dt, *(getLevel(lev).new_sources[rot_src]), 0, 0, NUM_STATE, ng);
+	MultiFab::Saxpy(S_new, dt, *(getLevel(lev).old_sources[rot_src]), 0, 0, getLevel(lev).old_sources[rot_src]->nComp(), ng);
+	MultiFab::Saxpy(S_new, dt, *(getLevel(lev).new_sources[rot_src]), 0, 0, getLevel(lev).new_sources[rot_src]->nComp(), ng);
 
 	Sb.clear();
 
+	getLevel(lev).invalidate_derive_cache();
+
     }
 
+    // The momenta, energy and rotation period have all changed, so the
+    // diagnostics from wd_update no longer hold at this time. The next
+    // call to update_extrema or gwstrain recomputes them.
+
+    diag_time = -1.0e200;
+
     // Check to see whether the relaxation should be turned off.
     // Note that at present the following check is only done on the
     // coarse grid but if we wanted more accuracy we could do a loop
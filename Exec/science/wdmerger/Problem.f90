@@ -271,171 +271,220 @@ end subroutine problem_restart
 
 
 
-! Return the mass-weighted center of mass and velocity
-! for the primary and secondary, for a given FAB.
-! Since this will rely on a sum over processors,
-! we should only add to the relevant variables
-! in anticipation of a MPI reduction, and not
-! overwrite them. Note that ultimately what we
-! are doing here is to use an old guess at the
-! effective potential of the primary and secondary
-! to generate a new estimate.
-
-subroutine wdcom(rho,  r_lo, r_hi, &
-                 xmom, px_lo, px_hi, &
-                 ymom, py_lo, py_hi, &
-                 zmom, pz_lo, pz_hi, &
-                 pmask, pm_lo, pm_hi, &
-                 smask, sm_lo, sm_hi, &
-                 vol,  vo_lo, vo_hi, &
-                 lo, hi, dx, time, &
-                 com_p_x, com_p_y, com_p_z, &
-                 com_s_x, com_s_y, com_s_z, &
-                 vel_p_x, vel_p_y, vel_p_z, &
-                 vel_s_x, vel_s_y, vel_s_z, &
-                 m_p, m_s) bind(C,name='wdcom')
-
-  use bl_constants_module, only: HALF, ZERO, ONE
-  use prob_params_module, only: problo, probhi, physbc_lo, physbc_hi, Symmetry
+! Accumulate, for one tile, everything that wd_update, update_extrema and
+! gwstrain need, so that they all come out of a single pass over the state.
+! The sums skip zones where use_mask == 1 and mask is zero (zones covered
+! by a finer level). They are added to rather than overwritten, in
+! anticipation of the MPI reduction. The layout of sums is
+!
+!   1-2   : masses of the primary and secondary
+!   3-8   : mass-weighted positions of the primary and secondary
+!   9-14  : momenta of the primary and secondary
+!   15-28 : volumes of the primary and secondary above densities 10**(0:6)
+!   29-37 : second time derivative of the quadrupole tensor
+!
+! maxes holds the maximum temperature and density over every zone, and,
+! if do_ts_te == 1, the maximum ratio of the sound-crossing time to the
+! nuclear energy injection timescale (as in ca_derenuctimescale).
+! Zones are assigned to the stars with the same prescription as
+! ca_derprimarymask and ca_dersecondarymask, using the current estimate
+! of the stellar masses and centers of mass. Ultimately this uses an old
+! guess at the effective potential of the stars to make a new estimate.
+
+subroutine sum_wd_diagnostics(lo, hi, &
+                              state, s_lo, s_hi, &
+                              phirot, pr_lo, pr_hi, &
+                              grav, g_lo, g_hi, &
+                              react, r_lo, r_hi, &
+                              vol, vo_lo, vo_hi, &
+                              mask, m_lo, m_hi, &
+                              use_mask, do_ts_te, dx, time, &
+                              sums, maxes) bind(C,name='sum_wd_diagnostics')
+
+  use bl_constants_module, only: ZERO, THIRD, HALF, ONE, TWO, M_PI
+  use prob_params_module, only: problo, probhi, physbc_lo, physbc_hi, Symmetry, center, dim
+  use probdata_module, only: mass_P, com_P, mass_S, com_S, stellar_density_threshold
+  use fundamental_constants_module, only: Gconst
+  use meth_params_module, only: NVAR, URHO, UMX, UMZ, UEINT, UTEMP, UFS, UFX
+  use network, only: nspec, naux
+  use eos_module, only: eos
+  use eos_type_module, only: eos_input_re, eos_t
+  use wdmerger_util_module, only: inertial_rotation, inertial_velocity
   use castro_util_module, only: position
 
   implicit none
 
+  integer         , intent(in   ) :: lo(3), hi(3)
+  integer         , intent(in   ) :: s_lo(3), s_hi(3)
+  integer         , intent(in   ) :: pr_lo(3), pr_hi(3)
+  integer         , intent(in   ) :: g_lo(3), g_hi(3)
   integer         , intent(in   ) :: r_lo(3), r_hi(3)
-  integer         , intent(in   ) :: px_lo(3), px_hi(3)
-  integer         , intent(in   ) :: py_lo(3), py_hi(3)
-  integer         , intent(in   ) :: pz_lo(3), pz_hi(3)
-  integer         , intent(in   ) :: pm_lo(3), pm_hi(3)
-  integer         , intent(in   ) :: sm_lo(3), sm_hi(3)
   integer         , intent(in   ) :: vo_lo(3), vo_hi(3)
+  integer         , intent(in   ) :: m_lo(3), m_hi(3)
 
-  double precision, intent(in   ) :: rho(r_lo(1):r_hi(1),r_lo(2):r_hi(2),r_lo(3):r_hi(3))
-  double precision, intent(in   ) :: xmom(px_lo(1):px_hi(1),px_lo(2):px_hi(2),px_lo(3):px_hi(3))
-  double precision, intent(in   ) :: ymom(py_lo(1):py_hi(1),py_lo(2):py_hi(2),py_lo(3):py_hi(3))
-  double precision, intent(in   ) :: zmom(pz_lo(1):pz_hi(1),pz_lo(2):pz_hi(2),pz_lo(3):pz_hi(3))
-  double precision, intent(in   ) :: pmask(pm_lo(1):pm_hi(1),pm_lo(2):pm_hi(2),pm_lo(3):pm_hi(3))
-  double precision, intent(in   ) :: smask(sm_lo(1):sm_hi(1),sm_lo(2):sm_hi(2),sm_lo(3):sm_hi(3))
+  double precision, intent(in   ) :: state(s_lo(1):s_hi(1),s_lo(2):s_hi(2),s_lo(3):s_hi(3),NVAR)
+  double precision, intent(in   ) :: phirot(pr_lo(1):pr_hi(1),pr_lo(2):pr_hi(2),pr_lo(3):pr_hi(3))
+  double precision, intent(in   ) :: grav(g_lo(1):g_hi(1),g_lo(2):g_hi(2),g_lo(3):g_hi(3),3)
+  double precision, intent(in   ) :: react(r_lo(1):r_hi(1),r_lo(2):r_hi(2),r_lo(3):r_hi(3),nspec+1)
   double precision, intent(in   ) :: vol(vo_lo(1):vo_hi(1),vo_lo(2):vo_hi(2),vo_lo(3):vo_hi(3))
+  double precision, intent(in   ) :: mask(m_lo(1):m_hi(1),m_lo(2):m_hi(2),m_lo(3):m_hi(3))
 
-  integer         , intent(in   ) :: lo(3), hi(3)
+  integer         , intent(in   ) :: use_mask, do_ts_te
   double precision, intent(in   ) :: dx(3), time
-  double precision, intent(inout) :: com_p_x, com_p_y, com_p_z
-  double precision, intent(inout) :: com_s_x, com_s_y, com_s_z
-  double precision, intent(inout) :: vel_p_x, vel_p_y, vel_p_z
-  double precision, intent(inout) :: vel_s_x, vel_s_y, vel_s_z
-  double precision, intent(inout) :: m_p, m_s
+  double precision, intent(inout) :: sums(37), maxes(3)
 
-  integer          :: i, j, k
-  double precision :: r(3), dm
+  integer          :: i, j, k, l, m, n, star
+  double precision :: rho, rhoInv, dm, enuc, t_s, t_e
+  double precision :: loc(3), r(3), pos(3), vel(3), g(3)
+  double precision :: r_P, r_S, phi_P, phi_S
+  double precision :: dQtt(3,3), Qtt(3,3)
+
+  type (eos_t)     :: eos_state
 
-  ! Add to the COM locations and velocities of the primary and secondary
-  ! depending on which potential dominates, ignoring unbound material.
-  ! Note that in this routine we actually are
-  ! summing mass-weighted quantities for the COM and the velocity; 
-  ! we will account for this at the end of the calculation in 
-  ! post_timestep() by dividing by the mass.
+  dQtt(:,:) = ZERO
 
   do k = lo(3), hi(3)
      do j = lo(2), hi(2)
         do i = lo(1), hi(1)
 
-           ! Our convention is that the COM locations for the WDs are 
-           ! absolute positions on the grid, not relative to the center.
+           rho = state(i,j,k,URHO)
 
-           r = position(i,j,k)
+           ! The extrema are taken over every zone, covered or not.
 
-           ! We account for symmetric boundaries in this sum as usual,
-           ! by adding to the position the locations that would exist
-           ! on the opposite side of the symmetric boundary.
+           maxes(1) = max(maxes(1), state(i,j,k,UTEMP))
+           maxes(2) = max(maxes(2), rho)
 
-           r = merge(r + (problo - r), r, physbc_lo(:) .eq. Symmetry)
-           r = merge(r + (r - probhi), r, physbc_hi(:) .eq. Symmetry)
+           if (do_ts_te == 1) then
 
-           dm = rho(i,j,k) * vol(i,j,k)
+              enuc = abs(react(i,j,k,nspec+1))
 
-           if (pmask(i,j,k) > ZERO) then
+              if (enuc > 1.d-100) then
 
-              m_p = m_p + dm
+                 rhoInv = ONE / rho
 
-              com_p_x = com_p_x + dm * r(1)
-              com_p_y = com_p_y + dm * r(2)
-              com_p_z = com_p_z + dm * r(3)
+                 eos_state % rho = rho
+                 eos_state % T   = state(i,j,k,UTEMP)
+                 eos_state % e   = state(i,j,k,UEINT) * rhoInv
+                 eos_state % xn  = state(i,j,k,UFS:UFS+nspec-1) * rhoInv
+                 eos_state % aux = state(i,j,k,UFX:UFX+naux-1) * rhoInv
 
-              vel_p_x = vel_p_x + xmom(i,j,k) * vol(i,j,k)
-              vel_p_y = vel_p_y + ymom(i,j,k) * vol(i,j,k)
-              vel_p_z = vel_p_z + zmom(i,j,k) * vol(i,j,k)
+                 t_e = eos_state % e / enuc
 
-           else if (smask(i,j,k) > ZERO) then
+                 call eos(eos_input_re, eos_state)
 
-              m_s = m_s + dm
+                 t_s = minval(dx(1:dim)) / eos_state % cs
 
-              com_s_x = com_s_x + dm * r(1)
-              com_s_y = com_s_y + dm * r(2)
-              com_s_z = com_s_z + dm * r(3)
+                 maxes(3) = max(maxes(3), t_s / t_e)
 
-              vel_s_x = vel_s_x + xmom(i,j,k) * vol(i,j,k)
-              vel_s_y = vel_s_y + ymom(i,j,k) * vol(i,j,k)
-              vel_s_z = vel_s_z + zmom(i,j,k) * vol(i,j,k)
+              endif
 
            endif
 
-        enddo
-     enddo
-  enddo
+           if (use_mask == 1) then
+              if (mask(i,j,k) == ZERO) cycle
+           endif
 
-end subroutine wdcom
+           loc = position(i,j,k)
 
+           ! Determine which star, if either, this zone belongs to.
 
+           star = 0
 
-! This function uses the known center of mass of the two white dwarfs,
-! and given a density cutoff, computes the total volume of all zones
-! whose density is greater or equal to that density cutoff.
-! We also impose a distance requirement so that we only look
-! at zones within the Roche lobe of the white dwarf.
+           if (rho >= stellar_density_threshold) then
 
-subroutine ca_volumeindensityboundary(rho,r_lo,r_hi, &
-                                      pmask,pm_lo,pm_hi, &
-                                      smask,sm_lo,sm_hi, &
-                                      vol,v_lo,v_hi, &
-                                      lo,hi,dx, &
-                                      volp,vols,rho_cutoff) &
-                                      bind(C,name='ca_volumeindensityboundary')
+              r_P = sqrt( sum( (loc - com_P)**2 ) )
+              r_S = sqrt( sum( (loc - com_S)**2 ) )
 
-  use bl_constants_module
+              phi_P = -Gconst * mass_P / r_P + phirot(i,j,k)
+              phi_S = -Gconst * mass_S / r_S + phirot(i,j,k)
 
-  implicit none
+              if (mass_P /= ZERO .and. phi_P < ZERO .and. phi_P < phi_S) then
+                 star = 1
+              else if (mass_S /= ZERO .and. phi_S < ZERO .and. phi_S < phi_P) then
+                 star = 2
+              endif
 
-  integer          :: r_lo(3), r_hi(3)
-  integer          :: pm_lo(3), pm_hi(3)
-  integer          :: sm_lo(3), sm_hi(3)
-  integer          :: v_lo(3), v_hi(3)
-  integer          :: lo(3), hi(3)
-  double precision :: volp, vols, rho_cutoff, dx(3)
-  double precision :: rho(r_lo(1):r_hi(1),r_lo(2):r_hi(2),r_lo(3):r_hi(3))
-  double precision :: pmask(pm_lo(1):pm_hi(1),pm_lo(2):pm_hi(2),pm_lo(3):pm_hi(3))
-  double precision :: smask(sm_lo(1):sm_hi(1),sm_lo(2):sm_hi(2),sm_lo(3):sm_hi(3))
-  double precision :: vol(v_lo(1):v_hi(1),v_lo(2):v_hi(2),v_lo(3):v_hi(3))
+           endif
 
-  integer          :: i, j, k
+           if (star > 0) then
 
-  volp = ZERO
-  vols = ZERO
+              ! Our convention is that the COM locations for the WDs are
+              ! absolute positions on the grid, not relative to the center.
+              ! We account for symmetric boundaries in this sum as usual,
+              ! by adding to the position the locations that would exist
+              ! on the opposite side of the symmetric boundary.
 
-  do k = lo(3), hi(3)
-     do j = lo(2), hi(2)
-        do i = lo(1), hi(1)
+              r = merge(loc + (problo - loc), loc, physbc_lo(:) .eq. Symmetry)
+              r = merge(r + (r - probhi), r, physbc_hi(:) .eq. Symmetry)
 
-           if (rho(i,j,k) > rho_cutoff) then
+              dm = rho * vol(i,j,k)
 
-              if (pmask(i,j,k) > ZERO) then
+              sums(star) = sums(star) + dm
 
-                 volp = volp + vol(i,j,k)
+              sums(3*star:3*star+2)   = sums(3*star:3*star+2)   + dm * r
+              sums(3*star+6:3*star+8) = sums(3*star+6:3*star+8) + state(i,j,k,UMX:UMZ) * vol(i,j,k)
 
-              else if (smask(i,j,k) > ZERO) then
+              do n = 0, 6
+                 if (rho > 10.0d0**n) then
+                    sums(7*star+8+n) = sums(7*star+8+n) + vol(i,j,k)
+                 endif
+              enddo
 
-                 vols = vols + vol(i,j,k)
+           endif
 
-              endif
+           ! Quadrupole tensor; see Equation 6.5 of Blanchet, Damour and Schafer 1990.
+
+           r = loc - center
+
+           if (rho > ZERO) then
+              rhoInv = ONE / rho
+           else
+              rhoInv = ZERO
+           endif
+
+           ! Account for rotation, if there is any. These will leave
+           ! r and vel unchanged, if not.
+
+           pos = inertial_rotation(r, time)
+
+           ! For constructing the velocity in the inertial frame, we need to
+           ! account for the fact that we have rotated the system already, so that
+           ! the r in omega x r is actually the position in the inertial frame, and
+           ! not the usual position in the rotating frame.
+
+           vel = state(i,j,k,UMX:UMZ) * rhoInv
+
+           vel = inertial_velocity(pos, vel, time)
+
+           ! We need to rotate the gravitational field to be consistent with the rotated position.
+
+           g = inertial_rotation(grav(i,j,k,:), time)
+
+           ! Absorb the factor of 2 outside the integral into the zone mass, for efficiency.
+
+           dm = TWO * rho * vol(i,j,k)
+
+           if (dim .eq. 3) then
+
+              do m = 1, 3
+                 do l = 1, 3
+                    dQtt(l,m) = dQtt(l,m) + dm * (vel(l) * vel(m) + pos(l) * g(m))
+                 enddo
+              enddo
+
+           else
+
+              ! For axisymmetric coordinates we integrate out the phi coordinate
+              ! of (x, y, z) = (R cos(phi), R sin(phi), z), with the cylindrical
+              ! z axis along the Cartesian x axis. The off-diagonal components
+              ! vanish and xx and yy pick up a factor of pi. The zone volume has
+              ! already been integrated over phi, so we divide it by 2*pi.
+
+              dm = dm / (TWO * M_PI)
+
+              dQtt(1,1) = dQtt(1,1) + dm * (TWO * M_PI) * (vel(2)**2 + pos(2) * g(2))
+              dQtt(2,2) = dQtt(2,2) + dm * M_PI * (vel(1)**2 + pos(1) * g(1))
+              dQtt(3,3) = dQtt(3,3) + dm * M_PI * (vel(1)**2 + pos(1) * g(1))
 
            endif
 
@@ -443,7 +492,25 @@ subroutine ca_volumeindensityboundary(rho,r_lo,r_hi, &
      enddo
   enddo
 
-end subroutine ca_volumeindensityboundary
+  ! Now take the symmetric trace-free part of the quadrupole moment.
+  ! The operator is defined in Equation 6.7 of Blanchet et al. (1990):
+  ! STF(A^{ij}) = 1/2 A^{ij} + 1/2 A^{ji} - 1/3 delta^{ij} sum_{k} A^{kk}.
+  ! The integral is linear, so each tile can do this independently.
+
+  Qtt(:,:) = ZERO
+
+  do l = 1, 3
+     do m = 1, 3
+
+        Qtt(l,m) = Qtt(l,m) + HALF * dQtt(l,m) + HALF * dQtt(m,l)
+        Qtt(l,l) = Qtt(l,l) - THIRD * dQtt(m,m)
+
+     enddo
+  enddo
+
+  sums(29:37) = sums(29:37) + reshape(Qtt, (/ 9 /))
+
+end subroutine sum_wd_diagnostics
 
 
 
@@ -535,150 +602,7 @@ end subroutine transform_to_inertial_frame
 
 
 
-! Calculate the second time derivative of the quadrupole moment tensor,
-! according to the formula in Equation 6.5 of Blanchet, Damour and Schafer 1990.
-! It involves integrating the mass distribution and then taking the symmetric 
-! trace-free part of the tensor. We can do the latter operation here since the 
-! integral is a linear operator and each part of the domain contributes independently.
-
-subroutine quadrupole_tensor_double_dot(rho, r_lo, r_hi, &
-                                        xmom, px_lo, px_hi, ymom, py_lo, py_hi, zmom, pz_lo, pz_hi, &
-                                        gravx, gx_lo, gx_hi, gravy, gy_lo, gy_hi, gravz, gz_lo, gz_hi, &
-                                        vol, vo_lo, vo_hi, &
-                                        lo, hi, dx, time, Qtt) bind(C,name='quadrupole_tensor_double_dot')
-
-  use bl_constants_module, only: ZERO, THIRD, HALF, ONE, TWO, M_PI
-  use prob_params_module, only: center, dim
-  use wdmerger_util_module, only: inertial_rotation, inertial_velocity
-  use castro_util_module, only: position
-
-  implicit none
-
-  integer         , intent(in   ) :: r_lo(3), r_hi(3)
-  integer         , intent(in   ) :: px_lo(3), px_hi(3)
-  integer         , intent(in   ) :: py_lo(3), py_hi(3)
-  integer         , intent(in   ) :: pz_lo(3), pz_hi(3)
-  integer         , intent(in   ) :: gx_lo(3), gx_hi(3)
-  integer         , intent(in   ) :: gy_lo(3), gy_hi(3)
-  integer         , intent(in   ) :: gz_lo(3), gz_hi(3)
-  integer         , intent(in   ) :: vo_lo(3), vo_hi(3)
-
-  double precision, intent(in   ) :: rho(r_lo(1):r_hi(1),r_lo(2):r_hi(2),r_lo(3):r_hi(3))
-  double precision, intent(in   ) :: xmom(px_lo(1):px_hi(1),px_lo(2):px_hi(2),px_lo(3):px_hi(3))
-  double precision, intent(in   ) :: ymom(py_lo(1):py_hi(1),py_lo(2):py_hi(2),py_lo(3):py_hi(3))
-  double precision, intent(in   ) :: zmom(pz_lo(1):pz_hi(1),pz_lo(2):pz_hi(2),pz_lo(3):pz_hi(3))
-  double precision, intent(in   ) :: gravx(gx_lo(1):gx_hi(1),gx_lo(2):gx_hi(2),gx_lo(3):gx_hi(3))
-  double precision, intent(in   ) :: gravy(gy_lo(1):gy_hi(1),gy_lo(2):gy_hi(2),gy_lo(3):gy_hi(3))
-  double precision, intent(in   ) :: gravz(gz_lo(1):gz_hi(1),gz_lo(2):gz_hi(2),gz_lo(3):gz_hi(3))
-  double precision, intent(in   ) :: vol(vo_lo(1):vo_hi(1),vo_lo(2):vo_hi(2),vo_lo(3):vo_hi(3))
-  integer         , intent(in   ) :: lo(3), hi(3)
-  double precision, intent(in   ) :: dx(3), time
-  double precision, intent(inout) :: Qtt(3,3)
-
-  integer          :: i, j, k, l, m
-  double precision :: r(3), pos(3), vel(3), g(3), rhoInv, dm
-  double precision :: dQtt(3,3)
-
-  dQtt(:,:) = ZERO
-
-  do k = lo(3), hi(3)
-     do j = lo(2), hi(2)
-        do i = lo(1), hi(1)
-
-           r = position(i,j,k) - center
-
-           if (rho(i,j,k) > ZERO) then
-              rhoInv = ONE / rho(i,j,k)
-           else
-              rhoInv = ZERO
-           endif
-
-           ! Account for rotation, if there is any. These will leave 
-           ! r and vel and changed, if not.
-
-           pos = inertial_rotation(r, time)
-
-           ! For constructing the velocity in the inertial frame, we need to 
-           ! account for the fact that we have rotated the system already, so that 
-           ! the r in omega x r is actually the position in the inertial frame, and 
-           ! not the usual position in the rotating frame. It has to be on physical 
-           ! grounds, because for binary orbits where the stars aren't moving, that 
-           ! r never changes, and so the contribution from rotation would never change.
-           ! But it must, since the motion vector of the stars changes in the inertial 
-           ! frame depending on where we are in the orbit.
-
-           vel(1) = xmom(i,j,k) * rhoInv
-           vel(2) = ymom(i,j,k) * rhoInv
-           vel(3) = zmom(i,j,k) * rhoInv
-
-           vel = inertial_velocity(pos, vel, time)
-
-           g(1) = gravx(i,j,k)
-           g(2) = gravy(i,j,k)
-           g(3) = gravz(i,j,k)
-
-           ! We need to rotate the gravitational field to be consistent with the rotated position.
-
-           g = inertial_rotation(g, time)
-
-           ! Absorb the factor of 2 outside the integral into the zone mass, for efficiency.
-
-           dm = TWO * rho(i,j,k) * vol(i,j,k)
-
-           if (dim .eq. 3) then
-
-              do m = 1, 3
-                 do l = 1, 3
-                    dQtt(l,m) = dQtt(l,m) + dM * (vel(l) * vel(m) + pos(l) * g(m))
-                 enddo
-              enddo
-
-           else
-
-              ! For axisymmetric coordinates we need to be careful here.
-              ! We want to calculate the quadrupole tensor in terms of
-              ! Cartesian coordinates but our coordinates are cylindrical (R, z).
-              ! What we can do is to first express the Cartesian coordinates
-              ! as (x, y, z) = (R cos(phi), R sin(phi), z). Then we can integrate
-              ! out the phi coordinate for each component. The off-diagonal components
-              ! all then vanish automatically. The on-diagonal components xx and yy
-              ! pick up a factor of cos**2(phi) which when integrated from (0, 2*pi)
-              ! yields pi. Note that we're going to choose that the cylindrical z axis
-              ! coincides with the Cartesian x-axis, which is our default choice.
-
-              ! We also need to then divide by the volume by 2*pi since
-              ! it has already been integrated out.
-
-              dm = dm / (TWO * M_PI)
-
-              dQtt(1,1) = dQtt(1,1) + dm * (TWO * M_PI) * (vel(2)**2 + pos(2) * g(2))
-              dQtt(2,2) = dQtt(2,2) + dm * M_PI * (vel(1)**2 + pos(1) * g(1))
-              dQtt(3,3) = dQtt(3,3) + dm * M_PI * (vel(1)**2 + pos(1) * g(1))
-
-           endif
-
-        enddo
-     enddo
-  enddo
-
-  ! Now take the symmetric trace-free part of the quadrupole moment.
-  ! The operator is defined in Equation 6.7 of Blanchet et al. (1990):
-  ! STF(A^{ij}) = 1/2 A^{ij} + 1/2 A^{ji} - 1/3 delta^{ij} sum_{k} A^{kk}.
-
-  do l = 1, 3
-     do m = 1, 3
-
-        Qtt(l,m) = Qtt(l,m) + HALF * dQtt(l,m) + HALF * dQtt(m,l)
-        Qtt(l,l) = Qtt(l,l) - THIRD * dQtt(m,m)
-
-     enddo
-  enddo
-
-end subroutine quadrupole_tensor_double_dot
-
-
-
-! Given the above quadrupole tensor, calculate the strain tensor.
+! Given the quadrupole tensor from sum_wd_diagnostics, calculate the strain tensor.
 
 subroutine gw_strain_tensor(h_plus_1, h_cross_1, h_plus_2, h_cross_2, h_plus_3, h_cross_3, Qtt, time) &
                             bind(C,name='gw_strain_tensor')
@@ -202,13 +202,6 @@ Castro::sum_integrated_quantities ()
 	rho_phirot += ca_lev.volProductSum("density", "phiRot", time, local_flag);
 #endif
 
-#ifdef GRAVITY
-#if (BL_SPACEDIM > 1)
-      // Gravitational wave signal. This is designed to add to these quantities so we can send them directly.
-      ca_lev.gwstrain(time, h_plus_1, h_cross_1, h_plus_2, h_cross_2, h_plus_3, h_cross_3, local_flag);
-#endif
-#endif
-
       // Integrated mass of all species on the domain.
       for (int i = 0; i < NumSpec; i++)
 	species_mass[i] += ca_lev.volWgtSum("rho_" + species_names[i], time, local_flag) / M_solar;
@@ -221,7 +214,7 @@ Castro::sum_integrated_quantities ()
 
     // Do the reductions.
 
-    int nfoo_sum = 24 + NumSpec;
+    int nfoo_sum = 18 + NumSpec;
 
     amrex::Array<Real> foo_sum(nfoo_sum);
 
@@ -239,15 +232,9 @@ Castro::sum_integrated_quantities ()
     foo_sum[15] = rho_e;
     foo_sum[16] = rho_phi;
     foo_sum[17] = rho_phirot;
-    foo_sum[18] = h_plus_1;
-    foo_sum[19] = h_cross_1;
-    foo_sum[20] = h_plus_2;
-    foo_sum[21] = h_cross_2;
-    foo_sum[22] = h_plus_3;
-    foo_sum[23] = h_cross_3;
 
     for (int i = 0; i < NumSpec; i++) {
-      foo_sum[i + 24] = species_mass[i];
+      foo_sum[i + 18] = species_mass[i];
     }
 
     amrex::ParallelDescriptor::ReduceRealSum(foo_sum.dataPtr(), nfoo_sum);
@@ -266,17 +253,17 @@ Castro::sum_integrated_quantities ()
     rho_e      = foo_sum[15];
     rho_phi    = foo_sum[16];
     rho_phirot = foo_sum[17];
-    h_plus_1   = foo_sum[18];
-    h_cross_1  = foo_sum[19];
-    h_plus_2   = foo_sum[20];
-    h_cross_2  = foo_sum[21];
-    h_plus_3   = foo_sum[22];
-    h_cross_3  = foo_sum[23];
 
     for (int i = 0; i < NumSpec; i++) {
-      species_mass[i] = foo_sum[i + 24];
+      species_mass[i] = foo_sum[i + 18];
     }
 
+#if (BL_SPACEDIM > 1) && defined(SELF_GRAVITY)
+    // Gravitational wave signal. The quadrupole moment is already summed over
+    // the levels and processors by the wdmerger diagnostics at this time.
+    gwstrain(time, h_plus_1, h_cross_1, h_plus_2, h_cross_2, h_plus_3, h_cross_3);
+#endif
+
     // Complete calculations for energy and momenta
 
     gravitational_energy = rho_phi;
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <string>
 #include <ctime>
+#include <limits>
 
 #include <AMReX_Utility.H>
 #include <AMReX_CONSTANTS.H>
@@ -22,6 +23,7 @@
 #include <AMReX_FillPatchUtil.H>
 #include <AMReX_ParmParse.H>
 #include <Castro_error_F.H>
+#include "Castro_async_io.H"
 
 #ifdef RADIATION
 #include "Radiation.H"
@@ -52,6 +54,10 @@ bool         Castro::dump_old      = false;
 
 int          Castro::verbose       = 0;
 ErrorList    Castro::err_list;
+int          Castro::tag_density     = 0;
+int          Castro::tag_temperature = 0;
+int          Castro::tag_pressure    = 0;
+int          Castro::tag_velocity    = 0;
 int          Castro::radius_grow   = 1;
 BCRec        Castro::phys_bc;
 int          Castro::NUM_STATE     = -1;
@@ -110,6 +116,13 @@ Gravity*     Castro::gravity  = 0;
 Diffusion*    Castro::diffusion  = 0;
 #endif
 
+// the background plotfile writer
+AsyncPlotWriter* Castro::async_plot_writer = 0;
+
+// derive cache statistics, reported with verbose output
+long Castro::derive_cache_hits   = 0;
+long Castro::derive_cache_misses = 0;
+
 #ifdef RADIATION
 int          Castro::do_radiation = -1;
 
@@ -142,6 +155,15 @@ int          Castro::num_state_type = 0;
 void
 Castro::variableCleanUp ()
 {
+  if (async_plot_writer != 0) {
+    if (verbose > 1 && ParallelDescriptor::IOProcessor()) {
+      std::cout << "Flushing outstanding plotfiles in variableCleanUp..." << '\n';
+    }
+    async_plot_writer->finish();
+    delete async_plot_writer;
+    async_plot_writer = 0;
+  }
+
 #ifdef SELF_GRAVITY
   if (gravity != 0) {
     if (verbose > 1 && ParallelDescriptor::IOProcessor()) {
@@ -393,6 +415,13 @@ Castro::read_params ()
 
 Castro::Castro ()
     :
+    fine_mask_boxes_built(false),
+    sborder_exchange_pending(false),
+    hydro_scratch_allocs(0),
+    derive_cache_used_mb(0.0),
+#if defined(REACTIONS) && !defined(SDC)
+    react_remapped(false),
+#endif
     old_sources(num_src),
     new_sources(num_src),
     prev_state(num_state_type)
@@ -407,6 +436,13 @@ Castro::Castro (Amr&            papa,
                 Real            time)
     :
     AmrLevel(papa,lev,level_geom,bl,dm,time),
+    fine_mask_boxes_built(false),
+    sborder_exchange_pending(false),
+    hydro_scratch_allocs(0),
+    derive_cache_used_mb(0.0),
+#if defined(REACTIONS) && !defined(SDC)
+    react_remapped(false),
+#endif
     old_sources(num_src),
     new_sources(num_src),
     prev_state(num_state_type)
@@ -624,13 +660,8 @@ Castro::buildMetrics ()
 void
 Castro::initMFs()
 {
-    fluxes.resize(3);
-
     for (int dir = 0; dir < BL_SPACEDIM; ++dir)
-	fluxes[dir].reset(new MultiFab(getEdgeBoxArray(dir), dmap, NUM_STATE, 0));
-
-    for (int dir = BL_SPACEDIM; dir < 3; ++dir)
-	fluxes[dir].reset(new MultiFab(get_new_data(State_Type).boxArray(), dmap, NUM_STATE, 0));
+	fluxes.define(dir, getEdgeBoxArray(dir), dmap, NUM_STATE);
 
 #if (BL_SPACEDIM <= 2)
     if (!Geometry::IsCartesian())
@@ -711,8 +742,8 @@ Castro::initMFs()
 	// These arrays hold all source terms that update the state.
 
 	for (int n = 0; n < num_src; ++n) {
-	    old_sources[n].reset(new MultiFab(grids, dmap, NUM_STATE, NUM_GROW));
-	    new_sources[n].reset(new MultiFab(grids, dmap, NUM_STATE, get_new_data(State_Type).nGrow()));
+	    old_sources[n].reset(new MultiFab(grids, dmap, source_ncomp(n), NUM_GROW));
+	    new_sources[n].reset(new MultiFab(grids, dmap, source_ncomp(n), get_new_data(State_Type).nGrow()));
 	}
 
 	// This array holds the hydrodynamics update.
@@ -731,6 +762,8 @@ Castro::setTimeLevel (Real time,
                       Real dt_new)
 {
     AmrLevel::setTimeLevel(time,dt_old,dt_new);
+
+    invalidate_derive_cache();
 }
 
 void
@@ -1084,221 +1117,239 @@ Castro::estTimeStep (Real dt_old)
 
     std::string limiter = "castro.max_dt";
 
-    // Start the hydro with the max_dt value, but divide by CFL
-    // to account for the fact that we multiply by it at the end.
-    // This ensures that if max_dt is more restrictive than the hydro
-    // criterion, we will get exactly max_dt for a timestep.
+    // All of the limiters that act on the state are evaluated together
+    // in one tiled sweep, and their minima are reduced in one call.
 
-    Real estdt_hydro = max_dt / cfl;
+    enum { dt_hydro = 0, dt_temp_diff, dt_enth_diff, dt_burn, num_dt_limiters };
+    const char* limiter_names[num_dt_limiters] = { "hydro", "temperature diffusion",
+                                                    "enthalpy diffusion", "burning" };
 
 #ifdef DIFFUSION
-    if (do_hydro or diffuse_temp or diffuse_enth)
+    const bool hydro_active = do_hydro || diffuse_temp || diffuse_enth;
 #else
-    if (do_hydro)
+    const bool hydro_active = do_hydro;
 #endif
-    {
 
 #ifdef RADIATION
-      if (Radiation::rad_hydro_combined) {
+    const bool rad_combined = Radiation::rad_hydro_combined;
+#else
+    const bool rad_combined = false;
+#endif
 
-	  // Compute radiation + hydro limited timestep.
+    // The radiation + hydro estimate replaces both the hydro and the
+    // diffusion estimates when it is in use.
 
-#ifdef _OPENMP
-#pragma omp parallel
+    bool use_limiter[num_dt_limiters];
+    use_limiter[dt_hydro]     = hydro_active && (do_hydro || rad_combined);
+#ifdef DIFFUSION
+    use_limiter[dt_temp_diff] = hydro_active && !rad_combined && diffuse_temp;
+    use_limiter[dt_enth_diff] = hydro_active && !rad_combined && diffuse_enth;
+#else
+    use_limiter[dt_temp_diff] = false;
+    use_limiter[dt_enth_diff] = false;
+#endif
+#ifdef REACTIONS
+    use_limiter[dt_burn]      = do_react;
+#else
+    use_limiter[dt_burn]      = false;
 #endif
-	  {
-	      Real dt = max_dt / cfl;
 
-	      const MultiFab& radMF = get_new_data(Rad_Type);
-	      FArrayBox gPr;
+    // Start the hydro with the max_dt value, but divide by CFL
+    // to account for the fact that we multiply by it at the end.
+    // This ensures that if max_dt is more restrictive than the hydro
+    // criterion, we will get exactly max_dt for a timestep.
+    // The diffusion limiters use the same CFL safety factor.
+
+    Real dt_init[num_dt_limiters];
+    dt_init[dt_hydro]     = max_dt / cfl;
+    dt_init[dt_temp_diff] = max_dt / cfl;
+    dt_init[dt_enth_diff] = max_dt / cfl;
+    dt_init[dt_burn]      = max_dt;
 
-	      for (MFIter mfi(stateMF, true); mfi.isValid(); ++mfi)
-	      {
-	          const Box& tbox = mfi.tilebox();
-	          const Box& vbox = mfi.validbox();
+    Array<Real> dt_limit(num_dt_limiters);
+    Array<int>  dt_grid(num_dt_limiters, -1);
 
-		  gPr.resize(tbox);
-		  radiation->estimate_gamrPr(stateMF[mfi], radMF[mfi], gPr, dx, vbox);
+    for (int n = 0; n < num_dt_limiters; ++n)
+        dt_limit[n] = dt_init[n];
 
-		  ca_estdt_rad(BL_TO_FORTRAN(stateMF[mfi]),
-			       BL_TO_FORTRAN(gPr),
-			       tbox.loVect(),tbox.hiVect(),dx,&dt);
-              }
-#ifdef _OPENMP
-#pragma omp critical (castro_estdt_rad)
+    bool any_limiter = false;
+    for (int n = 0; n < num_dt_limiters; ++n)
+        any_limiter = any_limiter || use_limiter[n];
+
+    if (any_limiter)
+    {
+#ifdef REACTIONS
+	const bool have_old = state[State_Type].hasOldData() && state[Reactions_Type].hasOldData();
+
+	const MultiFab& S_old = have_old ? get_old_data(State_Type) : stateMF;
+	const MultiFab& R_old = have_old ? get_old_data(Reactions_Type) : get_new_data(Reactions_Type);
+	const MultiFab& R_new = get_new_data(Reactions_Type);
 #endif
-	      {
-	          estdt_hydro = std::min(estdt_hydro,dt);
-              }
-          }
-      }
-      else
-      {
+#ifdef RADIATION
+	const MultiFab& radMF = get_new_data(Rad_Type);
 #endif
 
-	  // Compute hydro-limited timestep.
-	if (do_hydro)
-	  {
-
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
+	{
+	    Real dt_loc[num_dt_limiters];
+	    int  grid_loc[num_dt_limiters];
+
+	    for (int n = 0; n < num_dt_limiters; ++n) {
+		dt_loc[n] = dt_init[n];
+		grid_loc[n] = -1;
+	    }
+
+#ifdef RADIATION
+	    FArrayBox gPr;
+#endif
+
+	    for (MFIter mfi(stateMF,true); mfi.isValid(); ++mfi)
 	    {
-	      Real dt = max_dt / cfl;
+		const Box& box = mfi.tilebox();
+
+		Real dt_tile[num_dt_limiters];
+		for (int n = 0; n < num_dt_limiters; ++n)
+		    dt_tile[n] = dt_loc[n];
 
-	      for (MFIter mfi(stateMF,true); mfi.isValid(); ++mfi)
+		if (use_limiter[dt_hydro])
 		{
-		  const Box& box = mfi.tilebox();
+#ifdef RADIATION
+		    if (rad_combined) {
 
-		  ca_estdt(ARLIM_3D(box.loVect()), ARLIM_3D(box.hiVect()),
-			   BL_TO_FORTRAN_3D(stateMF[mfi]),
-			   ZFILL(dx),&dt);
-		}
-#ifdef _OPENMP
-#pragma omp critical (castro_estdt)
+			gPr.resize(box);
+			radiation->estimate_gamrPr(stateMF[mfi], radMF[mfi], gPr, dx, mfi.validbox());
+
+			ca_estdt_rad(BL_TO_FORTRAN(stateMF[mfi]),
+				     BL_TO_FORTRAN(gPr),
+				     box.loVect(),box.hiVect(),dx,&dt_tile[dt_hydro]);
+
+		    } else
 #endif
-	      {
-		estdt_hydro = std::min(estdt_hydro,dt);
-	      }
-	    }
-	  }
+		    ca_estdt(ARLIM_3D(box.loVect()), ARLIM_3D(box.hiVect()),
+			     BL_TO_FORTRAN_3D(stateMF[mfi]),
+			     ZFILL(dx),&dt_tile[dt_hydro]);
+		}
 
 #ifdef DIFFUSION
-	// Diffusion-limited timestep
-	// Note that the diffusion uses the same CFL safety factor
-	// as the main hydrodynamics timestep limiter.
-	if (diffuse_temp)
-	{
-#ifdef _OPENMP
-#pragma omp parallel
+		if (use_limiter[dt_temp_diff])
+		    ca_estdt_temp_diffusion(ARLIM_3D(box.loVect()), ARLIM_3D(box.hiVect()),
+					    BL_TO_FORTRAN_3D(stateMF[mfi]),
+					    ZFILL(dx),&dt_tile[dt_temp_diff]);
+
+		if (use_limiter[dt_enth_diff])
+		    ca_estdt_enth_diffusion(ARLIM_3D(box.loVect()), ARLIM_3D(box.hiVect()),
+					    BL_TO_FORTRAN_3D(stateMF[mfi]),
+					    ZFILL(dx),&dt_tile[dt_enth_diff]);
 #endif
-	    {
-	      Real dt = max_dt / cfl;
 
-	      for (MFIter mfi(stateMF,true); mfi.isValid(); ++mfi)
-		{
-		  const Box& box = mfi.tilebox();
-		  ca_estdt_temp_diffusion(ARLIM_3D(box.loVect()), ARLIM_3D(box.hiVect()),
-			  	          BL_TO_FORTRAN_3D(stateMF[mfi]),
-				          ZFILL(dx),&dt);
+#ifdef REACTIONS
+		if (use_limiter[dt_burn])
+		    ca_estdt_burning(BL_TO_FORTRAN_3D(S_old[mfi]),
+				     BL_TO_FORTRAN_3D(stateMF[mfi]),
+				     BL_TO_FORTRAN_3D(R_old[mfi]),
+				     BL_TO_FORTRAN_3D(R_new[mfi]),
+				     ARLIM_3D(box.loVect()),ARLIM_3D(box.hiVect()),
+				     ZFILL(dx),&dt_old,&dt_tile[dt_burn]);
+#endif
+
+		for (int n = 0; n < num_dt_limiters; ++n) {
+		    if (dt_tile[n] < dt_loc[n]) {
+			dt_loc[n] = dt_tile[n];
+			grid_loc[n] = mfi.index();
+		    }
 		}
-#ifdef _OPENMP
-#pragma omp critical (castro_estdt)
-#endif
-	      {
-		estdt_hydro = std::min(estdt_hydro,dt);
-	      }
 	    }
-	}
-	if (diffuse_enth)
-	{
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-	    {
-	      Real dt = max_dt / cfl;
 
-	      for (MFIter mfi(stateMF,true); mfi.isValid(); ++mfi)
-		{
-		  const Box& box = mfi.tilebox();
-		  ca_estdt_enth_diffusion(ARLIM_3D(box.loVect()), ARLIM_3D(box.hiVect()),
-				          BL_TO_FORTRAN_3D(stateMF[mfi]),
-				          ZFILL(dx),&dt);
-		}
 #ifdef _OPENMP
 #pragma omp critical (castro_estdt)
 #endif
-	      {
-		estdt_hydro = std::min(estdt_hydro,dt);
-	      }
+	    {
+		for (int n = 0; n < num_dt_limiters; ++n) {
+		    if (dt_loc[n] < dt_limit[n]) {
+			dt_limit[n] = dt_loc[n];
+			dt_grid[n] = grid_loc[n];
+		    }
+		}
 	    }
 	}
-#endif  // diffusion
-
-#ifdef RADIATION
-      }
-#endif
 
-       ParallelDescriptor::ReduceRealMin(estdt_hydro);
-       estdt_hydro *= cfl;
-       if (verbose && ParallelDescriptor::IOProcessor())
-           std::cout << "...estimated hydro-limited timestep at level " << level << ": " << estdt_hydro << std::endl;
+	Array<Real> dt_local(dt_limit);
 
-       // Determine if this is more restrictive than the maximum timestep limiting
+	ParallelDescriptor::ReduceRealMin(dt_limit.dataPtr(), num_dt_limiters);
 
-       if (estdt_hydro < estdt) {
-	 limiter = "hydro";
-	 estdt = estdt_hydro;
-       }
-    }
+	// The hydro and diffusion limiters share the CFL factor.
 
-#ifdef REACTIONS
-    MultiFab& S_new = get_new_data(State_Type);
-    MultiFab& R_new = get_new_data(Reactions_Type);
-
-    // Dummy value to start with
-    Real estdt_burn = max_dt;
-
-    if (do_react) {
+	for (int n = 0; n < dt_burn; ++n)
+	    dt_limit[n] *= cfl;
 
-        // Compute burning-limited timestep.
-
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-        {
-            Real dt = max_dt;
+	Real estdt_hydro = dt_limit[dt_hydro];
+	int hydro_binding = dt_hydro;
+	for (int n = dt_hydro; n < dt_burn; ++n) {
+	    if (use_limiter[n] && dt_limit[n] < estdt_hydro) {
+		estdt_hydro = dt_limit[n];
+		hydro_binding = n;
+	    }
+	}
 
-	    for (MFIter mfi(S_new); mfi.isValid(); ++mfi)
-	    {
-	        const Box& box = mfi.validbox();
+	if (hydro_active)
+	{
+	    if (verbose && ParallelDescriptor::IOProcessor())
+		std::cout << "...estimated hydro-limited timestep at level " << level << ": " << estdt_hydro << std::endl;
 
-		if (state[State_Type].hasOldData() && state[Reactions_Type].hasOldData()) {
+	    // Determine if this is more restrictive than the maximum timestep limiting
 
-		  MultiFab& S_old = get_old_data(State_Type);
-		  MultiFab& R_old = get_old_data(Reactions_Type);
+	    if (estdt_hydro < estdt) {
+		limiter = "hydro";
+		estdt = estdt_hydro;
+	    }
+	}
 
-		  ca_estdt_burning(BL_TO_FORTRAN_3D(S_old[mfi]),
-                                   BL_TO_FORTRAN_3D(S_new[mfi]),
-				   BL_TO_FORTRAN_3D(R_old[mfi]),
-				   BL_TO_FORTRAN_3D(R_new[mfi]),
-				   ARLIM_3D(box.loVect()),ARLIM_3D(box.hiVect()),
-				   ZFILL(dx),&dt_old,&dt);
+#ifdef REACTIONS
+	const Real estdt_burn = dt_limit[dt_burn];
 
-		} else {
+	if (use_limiter[dt_burn])
+	{
+	    if (verbose && ParallelDescriptor::IOProcessor() && estdt_burn < max_dt)
+		std::cout << "...estimated burning-limited timestep at level " << level << ": " << estdt_burn << std::endl;
 
-		  ca_estdt_burning(BL_TO_FORTRAN_3D(S_new[mfi]),
-                                   BL_TO_FORTRAN_3D(S_new[mfi]),
-				   BL_TO_FORTRAN_3D(R_new[mfi]),
-				   BL_TO_FORTRAN_3D(R_new[mfi]),
-				   ARLIM_3D(box.loVect()),ARLIM_3D(box.hiVect()),
-				   ZFILL(dx),&dt_old,&dt);
-
-		}
+	    // Determine if this is more restrictive than the hydro limiting
 
+	    if (estdt_burn < estdt) {
+		limiter = "burning";
+		estdt = estdt_burn;
 	    }
-#ifdef _OPENMP
-#pragma omp critical (castro_estdt_burning)
+	}
 #endif
-	    {
-	        estdt_burn = std::min(estdt_burn,dt);
-	    }
 
-        }
+	// Report the binding limiter and the grid it came from. Only the
+	// ranks that hold the global minimum offer their grid index.
 
-	ParallelDescriptor::ReduceRealMin(estdt_burn);
+	if (verbose > 1)
+	{
+	    int binding = -1;
+	    if (limiter == "hydro")
+		binding = hydro_binding;
+	    else if (limiter == "burning")
+		binding = dt_burn;
+
+	    if (binding >= 0)
+	    {
+		const Real scale = binding < dt_burn ? cfl : 1.0;
 
-	if (verbose && ParallelDescriptor::IOProcessor() && estdt_burn < max_dt)
-	  std::cout << "...estimated burning-limited timestep at level " << level << ": " << estdt_burn << std::endl;
+		int grid = std::numeric_limits<int>::max();
+		if (dt_grid[binding] >= 0 && dt_local[binding] * scale == dt_limit[binding])
+		    grid = dt_grid[binding];
 
-	// Determine if this is more restrictive than the hydro limiting
+		ParallelDescriptor::ReduceIntMin(grid);
 
-	if (estdt_burn < estdt) {
-	  limiter = "burning";
-	  estdt = estdt_burn;
+		if (ParallelDescriptor::IOProcessor() && grid < stateMF.boxArray().size())
+		    std::cout << "...timestep at level " << level << " limited by " << limiter_names[binding]
+			      << " in grid " << stateMF.boxArray()[grid] << std::endl;
+	    }
 	}
     }
-#endif
 
 #ifdef RADIATION
     if (do_radiation) radiation->EstTimeStep(estdt, level);
@@ -1487,6 +1538,14 @@ Castro::post_timestep (int iteration)
     if (level < finest_level)
 	avgDown();
 
+#ifdef SELF_GRAVITY
+    // The reflux and average-down changed the new state on this level,
+    // so the monopole radial bins cached from it are stale.
+
+    if (do_grav)
+	gravity->invalidate_radial_bins(level);
+#endif
+
     MultiFab& S_new = get_new_data(State_Type);
 
     // Clean up any aberrant state data generated by the reflux and average-down,
@@ -1494,6 +1553,8 @@ Castro::post_timestep (int iteration)
 
     clean_state(S_new);
 
+    invalidate_derive_cache();
+
     // Flush Fortran output
 
     if (verbose)
@@ -1508,6 +1569,11 @@ Castro::post_timestep (int iteration)
 
     problem_post_timestep();
 
+    // The hook may have changed the state on any level.
+
+    for (int lev = level; lev <= finest_level; ++lev)
+	getLevel(lev).invalidate_derive_cache();
+
 #endif
 
     if (level == 0)
@@ -1543,6 +1609,15 @@ Castro::post_timestep (int iteration)
 #ifdef SELF_GRAVITY
         if (moving_center) write_center();
 #endif
+
+	// Record the plotfiles that have been flushed in the background.
+
+	if (async_plot_writer != 0)
+	  async_plot_writer->poll();
+
+	if (verbose && derive_cache_mb > 0.0 && ParallelDescriptor::IOProcessor())
+	  std::cout << "Derive cache: " << derive_cache_hits << " hits, "
+		    << derive_cache_misses << " misses" << std::endl;
     }
 
 #ifdef RADIATION
@@ -1802,6 +1877,27 @@ Castro::post_regrid (int lbase,
                      int new_finest)
 {
     fine_mask.clear();
+    fine_mask_uncovered.clear();
+    fine_mask_covered.clear();
+    fine_mask_boxes_built = false;
+
+    avgdown_ba = BoxArray();
+    avgdown_grid.clear();
+
+#if (BL_SPACEDIM <= 2)
+    reflux_dr.clear();
+#endif
+
+    clear_hydro_scratch();
+
+    invalidate_derive_cache();
+
+#if defined(REACTIONS) && !defined(SDC)
+    react_cost.clear();
+    react_mask.reset();
+    react_remapped = false;
+    react_zone_cost.clear();
+#endif
 
 #ifdef PARTICLES
     if (TracerPC && level == lbase) {
@@ -1966,6 +2062,12 @@ Castro::post_init (Real stop_time)
 
 #endif
 
+    // The gravity solve and the problem hook may have changed the state
+    // on any level since the average-down.
+
+    for (int k = level; k <= finest_level; ++k)
+	getLevel(k).invalidate_derive_cache();
+
         int nstep = parent->levelSteps(0);
 	Real dtlev = parent->dtLevel(0);
 	Real cumtime = parent->cumTime();
@@ -2131,7 +2233,7 @@ Castro::FluxRegCrseInit() {
     Castro& fine_level = getLevel(level+1);
 
     for (int i = 0; i < BL_SPACEDIM; ++i)
-	fine_level.flux_reg.CrseInit(*fluxes[i], i, 0, 0, NUM_STATE, flux_crse_scale);
+	fine_level.flux_reg.CrseInit(fluxes[i], i, 0, 0, NUM_STATE, flux_crse_scale);
 
 #if (BL_SPACEDIM <= 2)
     if (!Geometry::IsCartesian())
@@ -2153,7 +2255,7 @@ Castro::FluxRegFineAdd() {
     if (level == 0) return;
 
     for (int i = 0; i < BL_SPACEDIM; ++i)
-	flux_reg.FineAdd(*fluxes[i], i, 0, 0, NUM_STATE, flux_fine_scale);
+	flux_reg.FineAdd(fluxes[i], i, 0, 0, NUM_STATE, flux_fine_scale);
 
 #if (BL_SPACEDIM <= 2)
     if (!Geometry::IsCartesian())
@@ -2236,25 +2338,17 @@ Castro::reflux(int crse_level, int fine_level)
 
 	// Also update the coarse fluxes MultiFabs using the reflux data. This should only make
 	// a difference if we re-evaluate the source terms later.
-
-	Array<std::unique_ptr<MultiFab> > temp_fluxes(3);
+	// The register is added straight into the fluxes, so only the faces on the
+	// coarse-fine interface are touched. Register faces shared by two fine grids
+	// were zeroed by ClearInternalBorders, so adding both sides is the same as
+	// the copy we used to make into a zeroed full-level temporary.
 
 	if (update_sources_after_reflux) {
 
-	    for (int i = 0; i < BL_SPACEDIM; ++i) {
-		temp_fluxes[i].reset(new MultiFab(crse_lev.fluxes[i]->boxArray(), 
-						  crse_lev.fluxes[i]->DistributionMap(),
-						  crse_lev.fluxes[i]->nComp(), crse_lev.fluxes[i]->nGrow()));
-		temp_fluxes[i]->setVal(0.0);
-	    }
 	    for (OrientationIter fi; fi; ++fi) {
 		const FabSet& fs = (*reg)[fi()];
 		int idir = fi().coordDir();
-		fs.copyTo(*temp_fluxes[idir], 0, 0, 0, temp_fluxes[idir]->nComp());
-	    }
-	    for (int i = 0; i < BL_SPACEDIM; ++i) {
-		MultiFab::Add(*crse_lev.fluxes[i], *temp_fluxes[i], 0, 0, crse_lev.fluxes[i]->nComp(), 0);
-		temp_fluxes[i].reset();
+		fs.plusTo(crse_lev.fluxes[idir], 0, 0, 0, crse_lev.fluxes.nComp());
 	    }
 
 	    // Reflux into the hydro_source array so that we have the most up-to-date version of it.
@@ -2272,8 +2366,11 @@ Castro::reflux(int crse_level, int fine_level)
 
 	    reg = &getLevel(lev).pres_reg;
 
-	    MultiFab dr(crse_lev.grids, crse_lev.dmap, 1, 0);
-	    dr.setVal(crse_lev.geom.CellSize(0));
+	    MultiFab& dr = crse_lev.reflux_dr;
+	    if (dr.empty()) {
+		dr.define(crse_lev.grids, crse_lev.dmap, 1, 0);
+		dr.setVal(crse_lev.geom.CellSize(0));
+	    }
 
 	    reg->ClearInternalBorders(crse_lev.geom);
 
@@ -2281,23 +2378,15 @@ Castro::reflux(int crse_level, int fine_level)
 
 	    if (update_sources_after_reflux) {
 
-		temp_fluxes[0].reset(new MultiFab(crse_lev.P_radial.boxArray(), 
-						  crse_lev.P_radial.DistributionMap(),
-						  crse_lev.P_radial.nComp(), crse_lev.P_radial.nGrow()));
-		temp_fluxes[0]->setVal(0.0);
-
                 for (OrientationIter fi; fi; ++fi) 
 		{
 		    const FabSet& fs = (*reg)[fi()];
 		    int idir = fi().coordDir();
 		    if (idir == 0) {
-			fs.copyTo(*temp_fluxes[idir], 0, 0, 0, temp_fluxes[idir]->nComp());
+			fs.plusTo(crse_lev.P_radial, 0, 0, 0, crse_lev.P_radial.nComp());
 		    }
                 }
 
-		MultiFab::Add(crse_lev.P_radial, *temp_fluxes[0], 0, 0, crse_lev.P_radial.nComp(), 0);
-		temp_fluxes[0].reset();
-
                 reg->Reflux(crse_lev.hydro_source, dr, 1.0, 0, Xmom, 1, crse_lev.geom);
 
 	    }
@@ -2321,20 +2410,10 @@ Castro::reflux(int crse_level, int fine_level)
 
 	    if (update_sources_after_reflux) {
 
-		for (int i = 0; i < BL_SPACEDIM; ++i) {
-		    temp_fluxes[i].reset(new MultiFab(crse_lev.rad_fluxes[i]->boxArray(), 
-						      crse_lev.rad_fluxes[i]->DistributionMap(),
-						      crse_lev.rad_fluxes[i]->nComp(), crse_lev.rad_fluxes[i]->nGrow()));
-		    temp_fluxes[i]->setVal(0.0);
-		}
 		for (OrientationIter fi; fi; ++fi) {
 		    const FabSet& fs = (*reg)[fi()];
 		    int idir = fi().coordDir();
-		    fs.copyTo(*temp_fluxes[idir], 0, 0, 0, temp_fluxes[idir]->nComp());
-		}
-		for (int i = 0; i < BL_SPACEDIM; ++i) {
-		    MultiFab::Add(*crse_lev.rad_fluxes[i], *temp_fluxes[i], 0, 0, crse_lev.rad_fluxes[i]->nComp(), 0);
-		    temp_fluxes[i].reset();
+		    fs.plusTo(*crse_lev.rad_fluxes[idir], 0, 0, 0, crse_lev.rad_fluxes[idir]->nComp());
 		}
 
 	    }
@@ -2390,6 +2469,11 @@ Castro::reflux(int crse_level, int fine_level)
     // ghost zone fills like diffusion depend on the data in the
     // coarser levels.
 
+    // The reflux and the gravity sync changed the state on these levels.
+
+    for (int lev = crse_level; lev <= parent->finestLevel(); ++lev)
+	getLevel(lev).invalidate_derive_cache();
+
     if (update_sources_after_reflux) {
 
 	for (int lev = fine_level; lev >= crse_level; --lev) {
@@ -2437,54 +2521,71 @@ Castro::avgDown ()
 
   if (level == parent->finestLevel()) return;
 
-  avgDown(State_Type);
+  Array<int> state_indices;
+
+  state_indices.push_back(State_Type);
 
 #ifdef SELF_GRAVITY
-  avgDown(Gravity_Type);
-  avgDown(PhiGrav_Type);
+  state_indices.push_back(Gravity_Type);
+  state_indices.push_back(PhiGrav_Type);
 #endif
 
 #ifdef ROTATION
-  avgDown(Rotation_Type);
-  avgDown(PhiRot_Type);
+  state_indices.push_back(Rotation_Type);
+  state_indices.push_back(PhiRot_Type);
 #endif
 
-  avgDown(Source_Type);
+  state_indices.push_back(Source_Type);
 
 #ifdef REACTIONS
-  avgDown(Reactions_Type);
+  state_indices.push_back(Reactions_Type);
 #endif
 
 #ifdef SDC
-  avgDown(SDC_Source_Type);
+  state_indices.push_back(SDC_Source_Type);
 #ifdef REACTIONS
-  avgDown(SDC_React_Type);
+  state_indices.push_back(SDC_React_Type);
 #endif
 #endif
 
 #ifdef RADIATION
   if (do_radiation) {
-    avgDown(Rad_Type);
+    state_indices.push_back(Rad_Type);
   }
 #endif
 
+  avgDown(state_indices);
+
 }
 
-void
-Castro::normalize_species (MultiFab& S_new)
+// The regions of the tile of mfi that the cleaning routines work on: the
+// tile grown by ng zones (by all of the ghost zones if ng < 0), or with
+// ghost_only just the part of that which lies outside the tile.
+
+static BoxList
+clean_boxes (const MFIter& mfi, int ng, bool ghost_only)
 {
-    int ng = S_new.nGrow();
+    const Box& bx = (ng < 0) ? mfi.growntilebox() : mfi.growntilebox(ng);
+
+    if (ghost_only)
+	return amrex::boxDiff(bx, mfi.tilebox());
+
+    return BoxList(bx);
+}
 
+void
+Castro::normalize_species (MultiFab& S_new, int ng, bool ghost_only)
+{
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
     for (MFIter mfi(S_new,true); mfi.isValid(); ++mfi)
     {
-       const Box& bx = mfi.growntilebox(ng);
        const int idx = mfi.tileIndex();
 
-       ca_normalize_species(BL_TO_FORTRAN_3D(S_new[mfi]), 
-			    ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()), &idx);
+       for (const Box& bx : clean_boxes(mfi, ng, ghost_only))
+	   ca_normalize_species(BL_TO_FORTRAN_3D(S_new[mfi]),
+				ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()), &idx);
     }
 }
 
@@ -2507,7 +2608,7 @@ Castro::enforce_consistent_e (MultiFab& S)
 }
 
 Real
-Castro::enforce_min_density (MultiFab& S_old, MultiFab& S_new)
+Castro::enforce_min_density (MultiFab& S_old, MultiFab& S_new, int ng, bool ghost_only)
 {
 
     // This routine sets the density in S_new to be larger than the density floor.
@@ -2539,18 +2640,17 @@ Castro::enforce_min_density (MultiFab& S_old, MultiFab& S_new)
 #endif
     for (MFIter mfi(S_new, true); mfi.isValid(); ++mfi) {
 
-	const Box& bx = mfi.growntilebox();
-
 	FArrayBox& stateold = S_old[mfi];
 	FArrayBox& statenew = S_new[mfi];
 	FArrayBox& vol      = volume[mfi];
 	const int idx = mfi.tileIndex();
-	
-	ca_enforce_minimum_density(stateold.dataPtr(), ARLIM_3D(stateold.loVect()), ARLIM_3D(stateold.hiVect()),
-				   statenew.dataPtr(), ARLIM_3D(statenew.loVect()), ARLIM_3D(statenew.hiVect()),
-				   vol.dataPtr(), ARLIM_3D(vol.loVect()), ARLIM_3D(vol.hiVect()),
-				   ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-				   &dens_change, &verbose, &idx);
+
+	for (const Box& bx : clean_boxes(mfi, ng, ghost_only))
+	    ca_enforce_minimum_density(stateold.dataPtr(), ARLIM_3D(stateold.loVect()), ARLIM_3D(stateold.hiVect()),
+				       statenew.dataPtr(), ARLIM_3D(statenew.loVect()), ARLIM_3D(statenew.hiVect()),
+				       vol.dataPtr(), ARLIM_3D(vol.loVect()), ARLIM_3D(vol.hiVect()),
+				       ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+				       &dens_change, &verbose, &idx);
 
     }
 
@@ -2605,6 +2705,117 @@ Castro::avgDown (int state_indx)
     amrex::average_down(S_fine, S_crse,
 			 fgeom, cgeom,
 			 0, S_fine.nComp(), fine_ratio);
+
+    invalidate_derive_cache();
+}
+
+void
+Castro::avgDown (const Array<int>& state_indices)
+{
+    BL_PROFILE("Castro::avgDown(state_indices)");
+
+    if (level == parent->finestLevel()) return;
+
+    Castro& fine_lev = getLevel(level+1);
+
+    const Geometry& fgeom = fine_lev.geom;
+    const Geometry& cgeom =          geom;
+
+    const int ntypes = state_indices.size();
+
+    Array<int> offset(ntypes);
+    int ncomp = 0;
+
+    for (int i = 0; i < ntypes; ++i) {
+	offset[i] = ncomp;
+	ncomp += get_new_data(state_indices[i]).nComp();
+    }
+
+    // Average each state type onto the coarsened fine grids, on the ranks
+    // that own the fine data, and pack the results into one MultiFab.
+
+    BoxArray crse_S_fine_BA = fine_lev.grids;
+    crse_S_fine_BA.coarsen(fine_ratio);
+
+    MultiFab crse_S_fine(crse_S_fine_BA, fine_lev.dmap, ncomp, 0);
+
+    for (int i = 0; i < ntypes; ++i)
+    {
+	MultiFab& S_fine = fine_lev.get_new_data(state_indices[i]);
+	const int nc = S_fine.nComp();
+
+	MultiFab crse_tmp(crse_S_fine_BA, fine_lev.dmap, nc, 0);
+
+	amrex::average_down(S_fine, crse_tmp,
+			     fgeom, cgeom,
+			     0, nc, fine_ratio);
+
+	MultiFab::Copy(crse_S_fine, crse_tmp, 0, offset[i], nc, 0);
+    }
+
+    // One parallel copy moves every state type to the owners of the
+    // covered coarse zones.
+
+    fine_lev.build_avgdown_layout();
+
+    MultiFab crse_packed(fine_lev.avgdown_ba, fine_lev.avgdown_dm, ncomp, 0);
+
+    crse_packed.copy(crse_S_fine, 0, 0, ncomp);
+
+    // Unpack into the coarse state data.
+
+    for (int i = 0; i < ntypes; ++i)
+    {
+	MultiFab& S_crse = get_new_data(state_indices[i]);
+	const int nc = S_crse.nComp();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	for (MFIter mfi(crse_packed); mfi.isValid(); ++mfi)
+	{
+	    const Box& bx = mfi.validbox();
+	    const int grid = fine_lev.avgdown_grid[mfi.index()];
+
+	    S_crse[grid].copy(crse_packed[mfi], bx, offset[i], bx, 0, nc);
+	}
+    }
+
+    invalidate_derive_cache();
+}
+
+void
+Castro::build_avgdown_layout()
+{
+    BL_ASSERT(level > 0); // because the layout lives on the coarser level
+
+    if (!avgdown_ba.empty()) return;
+
+    BoxArray baf = parent->boxArray(level);
+    baf.coarsen(crse_ratio);
+
+    const BoxArray& bac = parent->boxArray(level-1);
+    const DistributionMapping& dmc = parent->DistributionMap(level-1);
+
+    BoxList bl;
+    Array<int> pmap;
+
+    avgdown_grid.clear();
+
+    for (int i = 0; i < bac.size(); ++i)
+    {
+	const std::vector< std::pair<int,Box> >& isects = baf.intersections(bac[i]);
+
+	for (int ii = 0; ii < isects.size(); ++ii)
+	{
+	    bl.push_back(isects[ii].second);
+	    pmap.push_back(dmc[i]);
+	    avgdown_grid.push_back(i);
+	}
+    }
+
+    avgdown_ba = BoxArray(bl);
+    avgdown_dm = DistributionMapping(pmap);
 }
 
 void
@@ -2641,15 +2852,40 @@ Castro::errorEst (TagBoxArray& tags,
     if (post_step_regrid)
 	t = get_state_data(State_Type).curTime();
 
-    // Apply each of the built-in tagging functions.
+    // The built-in state criteria come first, as they did when they were
+    // the leading entries of err_list, and are all evaluated in one pass
+    // over the state. The gradients need one ghost zone.
+
+    if (tag_density || tag_temperature || tag_pressure || tag_velocity) {
+
+	MultiFab S_tag(grids, dmap, NUM_STATE, 1);
+	FillPatch(*this, S_tag, 1, t, State_Type, 0, NUM_STATE);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	for (MFIter mfi(S_tag,true); mfi.isValid(); ++mfi)
+	{
+	    const Box& tilebx = mfi.tilebox();
+
+	    // The state criteria set tags in the TagBox directly.
+	    ca_tag_state(ARLIM_3D(tilebx.loVect()), ARLIM_3D(tilebx.hiVect()),
+			 BL_TO_FORTRAN_3D(tags[mfi]),
+			 BL_TO_FORTRAN_3D(S_tag[mfi]),
+			 &tagval, &level,
+			 &tag_density, &tag_temperature,
+			 &tag_pressure, &tag_velocity);
+	}
+
+    }
+
+    // Apply each of the tagging functions that work on a derived quantity.
 
     for (int j = 0; j < err_list.size(); j++)
 	apply_tagging_func(tags, clearval, tagval, t, j);
 
     // Now we'll tag any user-specified zones using the full state array.
 
-    const int*  domain_lo = geom.Domain().loVect();
-    const int*  domain_hi = geom.Domain().hiVect();
     const Real* dx        = geom.CellSize();
     const Real* prob_lo   = geom.ProbLo();
 
@@ -2668,8 +2904,8 @@ Castro::errorEst (TagBoxArray& tags,
 
             TagBox&     tagfab  = tags[mfi];
 
-	    // We cannot pass tagfab to Fortran becuase it is BaseFab<char>.
-	    // So we are going to get a temporary integer array.
+	    // We cannot pass tagfab to the problem's Fortran because it
+	    // expects an integer array, so we get a temporary one.
 	    tagfab.get_itags(itags, tilebx);
 
             // data pointer and index space
@@ -2710,64 +2946,61 @@ Castro::apply_tagging_func(TagBoxArray& tags, int clearval, int tagval, Real tim
     const Real* dx        = geom.CellSize();
     const Real* prob_lo   = geom.ProbLo();
 
-    for (int j = 0; j < err_list.size(); j++)
-    {
-        auto mf = derive(err_list[j].name(), time, err_list[j].nGrow());
+    auto mf = derive(err_list[j].name(), time, err_list[j].nGrow());
 
-        BL_ASSERT(mf);
+    BL_ASSERT(mf);
 
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
+    {
+	Array<int>  itags;
+
+	for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
 	{
-	    Array<int>  itags;
+	    // FABs
+	    FArrayBox&  datfab  = (*mf)[mfi];
+	    TagBox&     tagfab  = tags[mfi];
 
-	    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
-	    {
-		// FABs
-		FArrayBox&  datfab  = (*mf)[mfi];
-		TagBox&     tagfab  = tags[mfi];
-
-		// tile box
-		const Box&  tilebx  = mfi.tilebox();
-
-		// physical tile box
-		const RealBox& pbx  = RealBox(tilebx,geom.CellSize(),geom.ProbLo());
-
-		//fab box
-		const Box&  datbox  = datfab.box();
-
-		// We cannot pass tagfab to Fortran becuase it is BaseFab<char>.
-		// So we are going to get a temporary integer array.
-		tagfab.get_itags(itags, tilebx);
-
-		// data pointer and index space
-		int*        tptr    = itags.dataPtr();
-		const int*  tlo     = tilebx.loVect();
-		const int*  thi     = tilebx.hiVect();
-		//
-		const int*  lo      = tlo;
-		const int*  hi      = thi;
-		//
-		const Real* xlo     = pbx.lo();
-		//
-		Real*       dat     = datfab.dataPtr();
-		const int*  dlo     = datbox.loVect();
-		const int*  dhi     = datbox.hiVect();
-		const int   ncomp   = datfab.nComp();
-
-		err_list[j].errFunc()(tptr, tlo, thi, &tagval,
-				      &clearval, dat, dlo, dhi,
-				      lo,hi, &ncomp, domain_lo, domain_hi,
-				      dx, xlo, prob_lo, &time, &level);
-		//
-		// Now update the tags in the TagBox.
-		//
-                tagfab.tags_and_untags(itags, tilebx);
-	    }
-	}
+	    // tile box
+	    const Box&  tilebx  = mfi.tilebox();
+
+	    // physical tile box
+	    const RealBox& pbx  = RealBox(tilebx,geom.CellSize(),geom.ProbLo());
+
+	    //fab box
+	    const Box&  datbox  = datfab.box();
+
+	    // We cannot pass tagfab to Fortran becuase it is BaseFab<char>.
+	    // So we are going to get a temporary integer array.
+	    tagfab.get_itags(itags, tilebx);
 
+	    // data pointer and index space
+	    int*        tptr    = itags.dataPtr();
+	    const int*  tlo     = tilebx.loVect();
+	    const int*  thi     = tilebx.hiVect();
+	    //
+	    const int*  lo      = tlo;
+	    const int*  hi      = thi;
+	    //
+	    const Real* xlo     = pbx.lo();
+	    //
+	    Real*       dat     = datfab.dataPtr();
+	    const int*  dlo     = datbox.loVect();
+	    const int*  dhi     = datbox.hiVect();
+	    const int   ncomp   = datfab.nComp();
+
+	    err_list[j].errFunc()(tptr, tlo, thi, &tagval,
+				  &clearval, dat, dlo, dhi,
+				  lo,hi, &ncomp, domain_lo, domain_hi,
+				  dx, xlo, prob_lo, &time, &level);
+	    //
+	    // Now update the tags in the TagBox.
+	    //
+	    tagfab.tags_and_untags(itags, tilebx);
+	}
     }
+
 }
 
 
@@ -2793,11 +3026,26 @@ Castro::derive (const std::string& name,
   }
 #endif
 
+  if (derive_cache_mb > 0.0) {
+      const MultiFab* cached = find_cached_derive(name, time, ngrow);
+      if (cached) {
+	  const int ncomp = cached->nComp();
+	  std::unique_ptr<MultiFab> mf(new MultiFab(cached->boxArray(), cached->DistributionMap(), ncomp, ngrow));
+	  MultiFab::Copy(*mf, *cached, 0, 0, ncomp, ngrow);
+	  return mf;
+      }
+  }
+
 #ifdef PARTICLES
-  return ParticleDerive(name,time,ngrow);
+  auto mf = ParticleDerive(name,time,ngrow);
 #else
-   return AmrLevel::derive(name,time,ngrow);
+  auto mf = AmrLevel::derive(name,time,ngrow);
 #endif
+
+  if (derive_cache_mb > 0.0)
+      cache_derive(name, time, *mf, 0, mf->nComp());
+
+  return mf;
 }
 
 void
@@ -2822,7 +3070,89 @@ Castro::derive (const std::string& name,
   }
 #endif
 
+    const DeriveRec* rec = derive_lst.get(name);
+    const int ncomp = rec ? rec->numDerive() : 1;
+
+    if (derive_cache_mb > 0.0) {
+	const MultiFab* cached = find_cached_derive(name, time, mf.nGrow());
+	if (cached &&
+	    cached->boxArray() == mf.boxArray() &&
+	    cached->DistributionMap() == mf.DistributionMap()) {
+	    MultiFab::Copy(mf, *cached, 0, dcomp, ncomp, mf.nGrow());
+	    return;
+	}
+    }
+
     AmrLevel::derive(name,time,mf,dcomp);
+
+    if (derive_cache_mb > 0.0)
+	cache_derive(name, time, mf, dcomp, ncomp);
+}
+
+const MultiFab*
+Castro::find_cached_derive (const std::string& name, Real time, int ngrow)
+{
+    for (auto it = derive_cache.begin(); it != derive_cache.end(); ++it) {
+	if (it->name == name && it->time == time && it->mf->nGrow() >= ngrow) {
+	    derive_cache.splice(derive_cache.begin(), derive_cache, it);
+	    derive_cache_hits++;
+	    return derive_cache.front().mf.get();
+	}
+    }
+
+    derive_cache_misses++;
+    return nullptr;
+}
+
+void
+Castro::cache_derive (const std::string& name, Real time,
+		      const MultiFab& mf, int scomp, int ncomp)
+{
+    // The size is reduced over the processors so that every processor
+    // makes the same eviction decisions, keeping later lookups (and the
+    // collective derives that follow a miss) in step.
+
+    long bytes = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+	bytes += mfi.fabbox().numPts() * ncomp * sizeof(Real);
+
+    Real mb = static_cast<Real>(bytes) / (1024.0 * 1024.0);
+    ParallelDescriptor::ReduceRealMax(mb);
+
+    if (mb > derive_cache_mb) return;
+
+    // Replace any entry we are superseding, then evict the least
+    // recently used entries until the new one fits.
+
+    for (auto it = derive_cache.begin(); it != derive_cache.end(); ++it) {
+	if (it->name == name && it->time == time) {
+	    derive_cache_used_mb -= it->mb;
+	    derive_cache.erase(it);
+	    break;
+	}
+    }
+
+    while (!derive_cache.empty() && derive_cache_used_mb + mb > derive_cache_mb) {
+	derive_cache_used_mb -= derive_cache.back().mb;
+	derive_cache.pop_back();
+    }
+
+    DeriveCacheEntry entry;
+    entry.name = name;
+    entry.time = time;
+    entry.mb   = mb;
+    entry.mf.reset(new MultiFab(mf.boxArray(), mf.DistributionMap(), ncomp, mf.nGrow()));
+    MultiFab::Copy(*entry.mf, mf, scomp, 0, ncomp, mf.nGrow());
+
+    derive_cache.push_front(std::move(entry));
+    derive_cache_used_mb += mb;
+}
+
+void
+Castro::invalidate_derive_cache ()
+{
+    derive_cache.clear();
+    derive_cache_used_mb = 0.0;
 }
 
 void
@@ -2851,7 +3181,7 @@ Castro::extern_init ()
 }
 
 void
-Castro::reset_internal_energy(MultiFab& S_new)
+Castro::reset_internal_energy(MultiFab& S_new, int ng, bool ghost_only)
 {
 
     MultiFab old_state;
@@ -2864,20 +3194,18 @@ Castro::reset_internal_energy(MultiFab& S_new)
         MultiFab::Copy(old_state, S_new, 0, 0, S_new.nComp(), 0);
     }
 
-    int ng = S_new.nGrow();
-
     // Ensure (rho e) isn't too small or negative
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
     for (MFIter mfi(S_new,true); mfi.isValid(); ++mfi)
     {
-        const Box& bx = mfi.growntilebox(ng);
 	const int idx = mfi.tileIndex();
 
-        ca_reset_internal_e(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-			    BL_TO_FORTRAN_3D(S_new[mfi]),
-			    print_fortran_warnings, &idx);
+	for (const Box& bx : clean_boxes(mfi, ng, ghost_only))
+	    ca_reset_internal_e(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+				BL_TO_FORTRAN_3D(S_new[mfi]),
+				print_fortran_warnings, &idx);
     }
 
     // Flush Fortran output
@@ -2918,10 +3246,10 @@ Castro::reset_internal_energy(MultiFab& S_new)
 }
 
 void
-Castro::computeTemp(MultiFab& State)
+Castro::computeTemp(MultiFab& State, int ng, bool ghost_only)
 {
 
-  reset_internal_energy(State);
+  reset_internal_energy(State, ng, ghost_only);
 
 #ifdef RADIATION
   FArrayBox temp;
@@ -2932,28 +3260,29 @@ Castro::computeTemp(MultiFab& State)
 #endif
   for (MFIter mfi(State,true); mfi.isValid(); ++mfi)
     {
-      const Box& bx = mfi.growntilebox();
-      
+      for (const Box& bx : clean_boxes(mfi, ng, ghost_only))
+      {
 #ifdef RADIATION
-      if (Radiation::do_real_eos == 0) {
-	temp.resize(bx);
-	temp.copy(State[mfi],bx,Eint,bx,0,1);
-	
-	ca_compute_temp_given_cv
-	  (bx.loVect(), bx.hiVect(), 
-	   BL_TO_FORTRAN(temp), 
-	   BL_TO_FORTRAN(State[mfi]),
-	   &Radiation::const_c_v, &Radiation::c_v_exp_m, &Radiation::c_v_exp_n);
-	
-	State[mfi].copy(temp,bx,0,bx,Temp,1);
-      } else {
+	if (Radiation::do_real_eos == 0) {
+	  temp.resize(bx);
+	  temp.copy(State[mfi],bx,Eint,bx,0,1);
+
+	  ca_compute_temp_given_cv
+	    (bx.loVect(), bx.hiVect(),
+	     BL_TO_FORTRAN(temp),
+	     BL_TO_FORTRAN(State[mfi]),
+	     &Radiation::const_c_v, &Radiation::c_v_exp_m, &Radiation::c_v_exp_n);
+
+	  State[mfi].copy(temp,bx,0,bx,Temp,1);
+	} else {
 #endif
-	const int idx = mfi.tileIndex();
-	ca_compute_temp(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-			BL_TO_FORTRAN_3D(State[mfi]), &idx);
+	  const int idx = mfi.tileIndex();
+	  ca_compute_temp(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+			  BL_TO_FORTRAN_3D(State[mfi]), &idx);
 #ifdef RADIATION
-      }
+	}
 #endif
+      }
     }
 }
 
@@ -3198,13 +3527,11 @@ Castro::build_fine_mask()
 
     if (!fine_mask.empty()) return fine_mask;
 
-    BoxArray baf = parent->boxArray(level);
-    baf.coarsen(crse_ratio);
+    build_fine_mask_boxes();
 
     const BoxArray& bac = parent->boxArray(level-1);
     const DistributionMapping& dmc = parent->DistributionMap(level-1);
     fine_mask.define(bac,dmc,1,0);
-    fine_mask.setVal(1.0);
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -3213,17 +3540,102 @@ Castro::build_fine_mask()
     {
         FArrayBox& fab = fine_mask[mfi];
 
-	const std::vector< std::pair<int,Box> >& isects = baf.intersections(fab.box());
+	fab.setVal(0.0);
 
-	for (int ii = 0; ii < isects.size(); ++ii)
+	const std::vector<Box>& uncovered = fine_mask_uncovered[mfi.index()];
+
+	for (int ii = 0; ii < uncovered.size(); ++ii)
 	{
-	    fab.setVal(0.0,isects[ii].second,0);
+	    fab.setVal(1.0,uncovered[ii],0);
 	}
     }
 
     return fine_mask;
 }
 
+void
+Castro::build_fine_mask_boxes()
+{
+    BL_ASSERT(level > 0); // because we are building a mask for the coarser level
+
+    if (fine_mask_boxes_built) return;
+
+    BoxArray baf = parent->boxArray(level);
+    baf.coarsen(crse_ratio);
+
+    const BoxArray& bac = parent->boxArray(level-1);
+    const DistributionMapping& dmc = parent->DistributionMap(level-1);
+
+    fine_mask_uncovered.clear();
+    fine_mask_covered.clear();
+
+    fine_mask_uncovered.resize(bac.size());
+    fine_mask_covered.resize(bac.size());
+
+    for (int i = 0; i < bac.size(); ++i)
+    {
+	if (dmc[i] != ParallelDescriptor::MyProc()) continue;
+
+	const std::vector< std::pair<int,Box> >& isects = baf.intersections(bac[i]);
+
+	BoxList covered;
+
+	for (int ii = 0; ii < isects.size(); ++ii)
+	{
+	    fine_mask_covered[i].push_back(isects[ii].second);
+	    covered.push_back(isects[ii].second);
+	}
+
+	const BoxList uncovered = amrex::complementIn(bac[i], covered);
+
+	for (BoxList::const_iterator bli = uncovered.begin(); bli != uncovered.end(); ++bli)
+	    fine_mask_uncovered[i].push_back(*bli);
+    }
+
+    fine_mask_boxes_built = true;
+}
+
+void
+Castro::fine_mask_tile_boxes (int grid, const Box& tbx,
+                              std::vector<Box>& uncovered,
+                              std::vector<Box>* covered,
+                              bool finemask)
+{
+    uncovered.clear();
+    if (covered) covered->clear();
+
+    if (level == parent->finestLevel() || !finemask)
+    {
+	uncovered.push_back(tbx);
+	return;
+    }
+
+    Castro& fine_level = getLevel(level+1);
+
+    // Build the box lists outside of any threaded region that uses them.
+
+    BL_ASSERT(fine_level.fine_mask_boxes_built);
+
+    const std::vector<Box>& ubx = fine_level.fine_mask_uncovered[grid];
+
+    for (int ii = 0; ii < ubx.size(); ++ii)
+    {
+	const Box bx = tbx & ubx[ii];
+	if (bx.ok()) uncovered.push_back(bx);
+    }
+
+    if (covered)
+    {
+	const std::vector<Box>& cbx = fine_level.fine_mask_covered[grid];
+
+	for (int ii = 0; ii < cbx.size(); ++ii)
+	{
+	    const Box bx = tbx & cbx[ii];
+	    if (bx.ok()) covered->push_back(bx);
+	}
+    }
+}
+
 iMultiFab&
 Castro::build_interior_boundary_mask (int ng)
 {
@@ -3320,7 +3732,7 @@ Castro::cons_to_prim(MultiFab& u, MultiFab& q, MultiFab& qaux)
 // value of enforce_min_density.
 
 Real
-Castro::clean_state(MultiFab& state) {
+Castro::clean_state(MultiFab& state, int ng, bool ghost_only) {
 
     // Enforce a minimum density.
 
@@ -3328,22 +3740,24 @@ Castro::clean_state(MultiFab& state) {
 
     MultiFab::Copy(temp_state, state, 0, 0, state.nComp(), state.nGrow());
 
-    Real frac_change = enforce_min_density(temp_state, state);
+    Real frac_change = enforce_min_density(temp_state, state, ng, ghost_only);
 
     // Ensure all species are normalized.
 
-    normalize_species(state);
+    normalize_species(state, ng, ghost_only);
 
-    // Sync the linear and hybrid momenta.
+    // Sync the linear and hybrid momenta. This only acts on the
+    // valid zones.
 
 #ifdef HYBRID_MOMENTUM
-    hybrid_sync(state);
+    if (!ghost_only)
+	hybrid_sync(state);
 #endif
 
     // Compute the temperature (note that this will also reset
     // the internal energy for consistency with the total energy).
 
-    computeTemp(state);
+    computeTemp(state, ng, ghost_only);
 
     return frac_change;
 
@@ -195,6 +195,9 @@ Castro::do_advance (Real time,
       // Initialize the new-time data. This copy needs to come after the
       // reactions.
 
+      if (sborder_exchange_pending && S_new.nGrow() > 0)
+	finish_state_exchange();
+
       MultiFab::Copy(S_new, Sborder, 0, 0, NUM_STATE, S_new.nGrow());
 
 
@@ -250,6 +253,12 @@ Castro::do_advance (Real time,
 
     } else if (do_ctu) {
 
+      // If nothing needed the ghost zones of Sborder, the exchange is
+      // still outstanding.
+
+      if (sborder_exchange_pending)
+	finish_state_exchange();
+
       // Sync up state after old sources and hydro source.
 
       frac_change = clean_state(S_new, Sborder);
@@ -364,7 +373,15 @@ Castro::initialize_do_advance(Real time, Real dt, int amr_iteration, int amr_ncy
       // for the CTU unsplit method, we always start with the old state
       Sborder.define(grids, dmap, NUM_STATE, NUM_GROW);
       const Real prev_time = state[State_Type].prevTime();
-      expand_state(Sborder, prev_time, NUM_GROW);
+
+      // On level 0 the FillPatch is only a copy, a ghost zone exchange,
+      // and the physical boundary fill, so we can post the exchange now
+      // and complete it once the ghost zones are first needed.
+
+      if (level == 0 && fillpatch_overlap)
+	start_state_exchange(Sborder, prev_time);
+      else
+	expand_state(Sborder, prev_time, NUM_GROW);
 
     } else {
       // for Method of lines, our initialization of Sborder depends on
@@ -403,6 +420,97 @@ Castro::initialize_do_advance(Real time, Real dt, int amr_iteration, int amr_ncy
 
 
 
+void
+Castro::start_state_exchange(MultiFab& S, Real time)
+{
+
+  // This does the same work as expand_state on level 0, but only posts
+  // the ghost zone exchange.  The valid data, which is all that the
+  // old-time gravity solve and the interior hydro tiles need, is
+  // cleaned and available immediately; finish_state_exchange must be
+  // called before the ghost zones are used.
+
+  BL_ASSERT(level == 0);
+  BL_ASSERT(!sborder_exchange_pending);
+
+  const Real prev_time = state[State_Type].prevTime();
+
+  BL_ASSERT(time == prev_time);
+
+  MultiFab& S_old = get_old_data(State_Type);
+
+  MultiFab::Copy(S, S_old, 0, 0, NUM_STATE, 0);
+
+  // Clean the valid zones before they are sent, so that every zone
+  // receives the same data that expand_state would have cleaned there.
+
+  clean_state(S, 0);
+
+  S.FillBoundary_nowait(geom.periodicity());
+
+  sborder_exchange_pending = true;
+  sborder_exchange_start = ParallelDescriptor::second();
+  sborder_exchange_time = time;
+
+}
+
+
+
+void
+Castro::finish_state_exchange()
+{
+
+  BL_ASSERT(sborder_exchange_pending);
+
+  BL_PROFILE("Castro::finish_state_exchange()");
+
+  const Real wait_start = ParallelDescriptor::second();
+
+  Sborder.FillBoundary_finish();
+
+  const Real wait_end = ParallelDescriptor::second();
+
+  sborder_exchange_pending = false;
+
+  // Now complete the FillPatch: fill the physical boundaries and
+  // clean the ghost zones as expand_state does. The valid zones were
+  // cleaned before the exchange and may already have been used, so
+  // they are left alone here.
+
+  StateDataPhysBCFunct physbcf(state[State_Type], 0, geom);
+  physbcf.FillBoundary(Sborder, 0, NUM_STATE, sborder_exchange_time);
+
+  clean_state(Sborder, -1, true);
+
+  if (verbose) {
+
+    // The overlap fraction is the share of the time the exchange was
+    // in flight during which we did other work rather than wait on it.
+
+    Real times[2] = {wait_start - sborder_exchange_start, wait_end - wait_start};
+
+#ifdef BL_LAZY
+    Lazy::QueueReduction( [=] () mutable {
+#endif
+	ParallelDescriptor::ReduceRealMax(times, 2, ParallelDescriptor::IOProcessorNumber());
+
+	if (ParallelDescriptor::IOProcessor()) {
+	  const Real total = times[0] + times[1];
+	  const Real overlap = total > 0.0 ? times[0] / total : 0.0;
+	  std::cout << "... state ghost zone exchange on level " << level << ": "
+		    << times[0] << " s overlapped, " << times[1] << " s waiting, "
+		    << "overlap fraction " << overlap << std::endl;
+	}
+#ifdef BL_LAZY
+      });
+#endif
+
+  }
+
+}
+
+
+
 void
 Castro::finalize_do_advance(Real time, Real dt, int amr_iteration, int amr_ncycle)
 {
@@ -423,6 +531,7 @@ Castro::finalize_do_advance(Real time, Real dt, int amr_iteration, int amr_ncycl
 	dSdt_new.setVal(0.0, NUM_GROW);
 
 	for (int n = 0; n < num_src; ++n) {
+	    if (!source_flag(n)) continue;
 	    MultiFab::Add(dSdt_new, *new_sources[n], Xmom, Xmom, 3, 0);
 	}
 
@@ -438,7 +547,8 @@ Castro::finalize_do_advance(Real time, Real dt, int amr_iteration, int amr_ncycl
     MultiFab& SDC_source_new = get_new_data(SDC_Source_Type);
     SDC_source_new.setVal(0.0, SDC_source_new.nGrow());
     for (int n = 0; n < num_src; ++n)
-	MultiFab::Add(SDC_source_new, *new_sources[n], 0, 0, NUM_STATE, new_sources[n]->nGrow());
+	if (source_flag(n))
+	    MultiFab::Add(SDC_source_new, *new_sources[n], 0, 0, new_sources[n]->nComp(), new_sources[n]->nGrow());
 #endif
 
 #ifdef RADIATION
@@ -462,6 +572,10 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
 
     ca_set_amr_info(level, amr_iteration, amr_ncycle, time, dt);
 
+    // The advance is going to change the state on this level.
+
+    invalidate_derive_cache();
+
     // Save the current iteration.
 
     iteration = amr_iteration;
@@ -534,17 +648,21 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
 
     clean_state(get_old_data(State_Type));
 
-    // Make a copy of the MultiFabs in the old and new state data in case we may do a retry.
-    
-    if (use_retry) {
+    // Make a copy of the state data in case we may do a retry. The new
+    // data of the state types that also have old data is not saved:
+    // after the swap above it holds nothing the advance needs, and it
+    // is overwritten by the advance.
 
-      // Store the old and new time levels.
+    if (use_retry) {
 
       for (int k = 0; k < num_state_type; k++) {
 
-	prev_state[k].reset(new StateData());
+	  if (k == State_Type) continue;
 
-	StateData::Initialize(*prev_state[k], state[k]);
+	  const MultiFab& S = state[k].hasOldData() ? get_old_data(k) : get_new_data(k);
+
+	  prev_state[k].reset(new MultiFab(S.boxArray(), S.DistributionMap(), S.nComp(), S.nGrow()));
+	  MultiFab::Copy(*prev_state[k], S, 0, 0, S.nComp(), S.nGrow());
 
       }
 
@@ -560,8 +678,8 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
       // keep them for the life of the simulation.
 
       for (int n = 0; n < num_src; ++n) {
-	old_sources[n].reset(new MultiFab(grids, dmap, NUM_STATE, NUM_GROW));
-	new_sources[n].reset(new MultiFab(grids, dmap, NUM_STATE, get_new_data(State_Type).nGrow()));
+	old_sources[n].reset(new MultiFab(grids, dmap, source_ncomp(n), NUM_GROW));
+	new_sources[n].reset(new MultiFab(grids, dmap, source_ncomp(n), get_new_data(State_Type).nGrow()));
       }
 
       // This array holds the hydrodynamics update.
@@ -594,8 +712,7 @@ Castro::initialize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle
 
     // Zero out the current fluxes.
 
-    for (int dir = 0; dir < 3; ++dir)
-	fluxes[dir]->setVal(0.0);
+    fluxes.setVal(0.0);
 
 #if (BL_SPACEDIM <= 2)
     if (!Geometry::IsCartesian())
@@ -616,6 +733,8 @@ void
 Castro::finalize_advance(Real time, Real dt, int amr_iteration, int amr_ncycle)
 {
 
+    invalidate_derive_cache();
+
     // Add the material lost in this timestep to the cumulative losses.
 
     if (track_grid_losses) {
@@ -767,15 +886,21 @@ Castro::retry_advance(Real time, Real dt, int amr_iteration, int amr_ncycle)
 	int sub_iteration = 1;
 	Real dt_advance = dt / sub_ncycle;
 
-	// Restore the original values of the state data.
+	// Restore the original values of the state data. The old
+	// State_Type data is still intact, so this is where we save it,
+	// before the subcycles overwrite it.
 
-	for (int k = 0; k < num_state_type; k++) {
+	prev_state[State_Type].reset(new MultiFab(S_old.boxArray(), S_old.DistributionMap(),
+						  S_old.nComp(), S_old.nGrow()));
+	MultiFab::Copy(*prev_state[State_Type], S_old, 0, 0, S_old.nComp(), S_old.nGrow());
 
-	  if (prev_state[k]->hasOldData())
-	      state[k].copyOld(*prev_state[k]);
+	for (int k = 0; k < num_state_type; k++) {
 
-	  if (prev_state[k]->hasNewData())
-	      state[k].copyNew(*prev_state[k]);
+	  if (k != State_Type) {
+	      const MultiFab& S_prev = *prev_state[k];
+	      MultiFab& S_k = state[k].hasOldData() ? get_old_data(k) : get_new_data(k);
+	      MultiFab::Copy(S_k, S_prev, 0, 0, S_prev.nComp(), S_prev.nGrow());
+	  }
 
 	  // Anticipate the swapTimeLevels to come.
 
@@ -800,6 +925,13 @@ Castro::retry_advance(Real time, Real dt, int amr_iteration, int amr_ncycle)
 	  for (int i = 0; i < n_lost; i++)
 	    material_lost_through_boundary_temp[i] = 0.0;
 
+#ifdef SELF_GRAVITY
+	// The restored state invalidates any cached radial mass bins.
+
+	if (do_grav)
+	    gravity->invalidate_radial_bins(level);
+#endif
+
 	// Subcycle until we've reached the target time.
 
 	while (subcycle_time < time + dt) {
@@ -869,8 +1001,10 @@ Castro::retry_advance(Real time, Real dt, int amr_iteration, int amr_ncycle)
 
 	for (int k = 0; k < num_state_type; k++) {
 
-           if (prev_state[k]->hasOldData())
-	      state[k].copyOld(*prev_state[k]);
+           if (state[k].hasOldData()) {
+	      const MultiFab& S_prev = *prev_state[k];
+	      MultiFab::Copy(get_old_data(k), S_prev, 0, 0, S_prev.nComp(), S_prev.nGrow());
+	   }
 
 	   state[k].setTimeLevel(time + dt, dt, 0.0);
 
@@ -0,0 +1,204 @@
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include "Castro_async_io.H"
+
+using namespace amrex;
+
+//
+// Amr writes each plotfile into dir.temp and renames it to dir once all
+// of the levels have been handed to us, so by the time a file is opened
+// here its directory may already have moved.
+//
+static FILE*
+open_plotfile_path (const std::string& path, const char* mode)
+{
+    FILE* fp = std::fopen(path.c_str(), mode);
+
+    if (fp == 0) {
+        std::string::size_type pos = path.find(".temp/");
+        if (pos != std::string::npos) {
+            std::string moved = path;
+            moved.erase(pos, 5);
+            fp = std::fopen(moved.c_str(), mode);
+        }
+    }
+
+    return fp;
+}
+
+AsyncPlotWriter::AsyncPlotWriter (int _max_queue)
+    :
+    max_queue(_max_queue > 0 ? _max_queue : 1),
+    nplotfiles(0),
+    stop(false)
+{
+    worker = std::thread(&AsyncPlotWriter::work, this);
+}
+
+AsyncPlotWriter::~AsyncPlotWriter ()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    job_cv.notify_all();
+    worker.join();
+}
+
+void
+AsyncPlotWriter::begin (const std::string& dir)
+{
+    std::unique_lock<std::mutex> lock(mtx);
+
+    // Every plotfile we already have is complete as far as the main
+    // thread is concerned, so only the ones still on the queue count.
+
+    done_cv.wait(lock, [this] {
+        int pending = 0;
+        for (const Plotfile& p : plotfiles)
+            if (p.nwritten < p.nqueued) pending++;
+        return pending < max_queue;
+    });
+
+    Plotfile p;
+    p.dir      = dir;
+    p.id       = nplotfiles++;
+    p.nqueued  = 0;
+    p.nwritten = 0;
+    plotfiles.push_back(p);
+}
+
+void
+AsyncPlotWriter::add (const std::string& file, std::string& data)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        BL_ASSERT(!plotfiles.empty());
+
+        Job job;
+        job.file     = file;
+        job.data.swap(data);
+        job.plotfile = plotfiles.back().id;
+        jobs.push_back(std::move(job));
+
+        plotfiles.back().nqueued++;
+    }
+    job_cv.notify_one();
+}
+
+void
+AsyncPlotWriter::poll ()
+{
+    int ndone = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const Plotfile& p : plotfiles) {
+            if (p.nwritten < p.nqueued) break;
+            ndone++;
+        }
+    }
+
+    ParallelDescriptor::ReduceIntMin(ndone);
+
+    for (int i = 0; i < ndone; i++) {
+
+        std::string dir;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            dir = plotfiles.front().dir;
+            plotfiles.pop_front();
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+
+            std::string FullPathJobInfoFile = dir;
+            FullPathJobInfoFile += "/job_info";
+
+            FILE* fp = open_plotfile_path(FullPathJobInfoFile, "a");
+
+            if (fp != 0) {
+                std::time_t now = std::time(0);
+                std::fprintf(fp, "plotfile data synced to disk: %s", std::ctime(&now));
+                std::fclose(fp);
+            }
+            else {
+                amrex::Warning(("AsyncPlotWriter: unable to update job_info for " + dir).c_str());
+            }
+
+        }
+
+    }
+}
+
+void
+AsyncPlotWriter::finish ()
+{
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        done_cv.wait(lock, [this] {
+            for (const Plotfile& p : plotfiles)
+                if (p.nwritten < p.nqueued) return false;
+            return true;
+        });
+    }
+
+    poll();
+}
+
+void
+AsyncPlotWriter::work ()
+{
+    for (;;) {
+
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            job_cv.wait(lock, [this] { return stop || !jobs.empty(); });
+
+            if (jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        write_job(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (Plotfile& p : plotfiles)
+                if (p.id == job.plotfile)
+                    p.nwritten++;
+        }
+        done_cv.notify_all();
+
+    }
+}
+
+void
+AsyncPlotWriter::write_job (const Job& job)
+{
+    FILE* fp = open_plotfile_path(job.file, "wb");
+
+    if (fp == 0)
+        amrex::Abort(("AsyncPlotWriter: unable to open " + job.file).c_str());
+
+    if (std::fwrite(job.data.data(), 1, job.data.size(), fp) != job.data.size())
+        amrex::Abort(("AsyncPlotWriter: failed writing " + job.file).c_str());
+
+    std::fflush(fp);
+#ifndef WIN32
+    fsync(fileno(fp));
+#endif
+    std::fclose(fp);
+}
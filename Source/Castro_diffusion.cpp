@@ -53,7 +53,7 @@ Castro::construct_new_diff_source(Real time, Real dt)
 
     new_sources[diff_src]->mult(0.5);
 
-    MultiFab::Saxpy(*new_sources[diff_src], -0.5, *old_sources[diff_src], 0, 0, NUM_STATE, ng);
+    MultiFab::Saxpy(*new_sources[diff_src], -0.5, *old_sources[diff_src], 0, 0, new_sources[diff_src]->nComp(), ng);
 
 }
 
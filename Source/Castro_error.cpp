@@ -23,16 +23,15 @@ Castro::ErrorSetUp ()
 //  err_list.add("density",2,ErrorRec::Special,ca_laplac_error);
 //  err_list.add("pressure",2,ErrorRec::Special,ca_laplac_error);
 
-    err_list.add("density",1,ErrorRec::Special,ca_denerror);
-    err_list.add("Temp",1,ErrorRec::Special,ca_temperror);
-    err_list.add("pressure",1,ErrorRec::Special,ca_presserror);
-    err_list.add("x_velocity",1,ErrorRec::Special,ca_velerror);
-#if (BL_SPACEDIM >= 2)
-    err_list.add("y_velocity",1,ErrorRec::Special,ca_velerror);
-#endif
-#if (BL_SPACEDIM == 3)
-    err_list.add("z_velocity",1,ErrorRec::Special,ca_velerror);
-#endif
+    // The density, temperature, pressure and velocity criteria (the same
+    // ones as ca_denerror, ca_temperror, ca_presserror and ca_velerror)
+    // are evaluated together from the state in errorEst by ca_tag_state,
+    // so they don't need a derived MultiFab each.
+
+    tag_density = 1;
+    tag_temperature = 1;
+    tag_pressure = 1;
+    tag_velocity = 1;
 
 //   err_list.add("entropy",1,ErrorRec::Special,ca_enterror);
 
@@ -37,7 +37,7 @@ Castro::construct_new_ext_source(Real time, Real dt)
 
     new_sources[ext_src]->mult(0.5);
 
-    MultiFab::Saxpy(*new_sources[ext_src],-0.5,*old_sources[ext_src],0,0,NUM_STATE,ng);
+    MultiFab::Saxpy(*new_sources[ext_src],-0.5,*old_sources[ext_src],0,0,new_sources[ext_src]->nComp(),ng);
 
 }
 
@@ -46,9 +46,6 @@ Castro::construct_new_ext_source(Real time, Real dt)
 void
 Castro::fill_ext_source (Real time, Real dt, MultiFab& state_old, MultiFab& state_new, MultiFab& ext_src, int ng)
 {
-    const Real* dx = geom.CellSize();
-    const Real* prob_lo = geom.ProbLo();
-
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -57,20 +54,32 @@ Castro::fill_ext_source (Real time, Real dt, MultiFab& state_old, MultiFab& stat
 
         const Box& bx = mfi.growntilebox(ng);
 
+	ext_source_tile(bx, state_old[mfi], state_new[mfi], ext_src[mfi], time, dt);
+    }
+}
+
+
+
+void
+Castro::ext_source_tile (const Box& bx, FArrayBox& state_old, FArrayBox& state_new,
+                         FArrayBox& src, Real time, Real dt)
+{
+    const Real* dx = geom.CellSize();
+    const Real* prob_lo = geom.ProbLo();
+
 #ifdef DIMENSION_AGNOSTIC
-        BL_FORT_PROC_CALL(CA_EXT_SRC,ca_ext_src)
-	  (ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-	   BL_TO_FORTRAN_3D(state_old[mfi]),
-	   BL_TO_FORTRAN_3D(state_new[mfi]),
-	   BL_TO_FORTRAN_3D(ext_src[mfi]),
-	   ZFILL(prob_lo),ZFILL(dx),&time,&dt);
+    BL_FORT_PROC_CALL(CA_EXT_SRC,ca_ext_src)
+      (ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+       BL_TO_FORTRAN_3D(state_old),
+       BL_TO_FORTRAN_3D(state_new),
+       BL_TO_FORTRAN_3D(src),
+       ZFILL(prob_lo),ZFILL(dx),&time,&dt);
 #else
-	BL_FORT_PROC_CALL(CA_EXT_SRC,ca_ext_src)
-	  (bx.loVect(), bx.hiVect(),
-	   BL_TO_FORTRAN(state_old[mfi]),
-	   BL_TO_FORTRAN(state_new[mfi]),
-	   BL_TO_FORTRAN(ext_src[mfi]),
-	   prob_lo,dx,&time,&dt);
+    BL_FORT_PROC_CALL(CA_EXT_SRC,ca_ext_src)
+      (bx.loVect(), bx.hiVect(),
+       BL_TO_FORTRAN(state_old),
+       BL_TO_FORTRAN(state_new),
+       BL_TO_FORTRAN(src),
+       prob_lo,dx,&time,&dt);
 #endif
-    }
 }
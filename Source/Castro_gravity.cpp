@@ -287,10 +287,16 @@ void Castro::construct_new_gravity_source(Real time, Real dt)
 #pragma omp parallel
 #endif
     {
+	FArrayBox dead_flux;
+
 	for (MFIter mfi(S_new,true); mfi.isValid(); ++mfi)
 	{
 	    const Box& bx = mfi.tilebox();
 
+	    FArrayBox& flux_x = fluxes.fab3d(0, mfi, dead_flux);
+	    FArrayBox& flux_y = fluxes.fab3d(1, mfi, dead_flux);
+	    FArrayBox& flux_z = fluxes.fab3d(2, mfi, dead_flux);
+
 	    ca_corrgsrc(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
 			ARLIM_3D(domlo), ARLIM_3D(domhi),
 			BL_TO_FORTRAN_3D(S_old[mfi]),
@@ -302,9 +308,9 @@ void Castro::construct_new_gravity_source(Real time, Real dt)
 			BL_TO_FORTRAN_3D(grav_new[mfi]),
 #endif
 			BL_TO_FORTRAN_3D(volume[mfi]),
-			BL_TO_FORTRAN_3D((*fluxes[0])[mfi]),
-			BL_TO_FORTRAN_3D((*fluxes[1])[mfi]),
-			BL_TO_FORTRAN_3D((*fluxes[2])[mfi]),
+			BL_TO_FORTRAN_3D(flux_x),
+			BL_TO_FORTRAN_3D(flux_y),
+			BL_TO_FORTRAN_3D(flux_z),
 			BL_TO_FORTRAN_3D((*new_sources[grav_src])[mfi]),
 			ZFILL(dx),dt,&time);
 
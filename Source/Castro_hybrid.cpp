@@ -31,7 +31,7 @@ Castro::construct_new_hybrid_source(Real time, Real dt)
 
     new_sources[hybrid_src]->mult(0.5);
 
-    MultiFab::Saxpy(*new_sources[hybrid_src],-0.5,*old_sources[hybrid_src],0,0,NUM_STATE,ng);
+    MultiFab::Saxpy(*new_sources[hybrid_src],-0.5,*old_sources[hybrid_src],0,0,new_sources[hybrid_src]->nComp(),ng);
 }
 
 
@@ -50,9 +50,7 @@ Castro::fill_hybrid_hydro_source(MultiFab& sources, MultiFab& state)
 
     const Box& bx = mfi.growntilebox(ng);
 
-    ca_hybrid_hydro_source(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-			   BL_TO_FORTRAN_3D(state[mfi]),
-			   BL_TO_FORTRAN_3D(sources[mfi]));
+    hybrid_source_tile(bx, state[mfi], sources[mfi]);
 
   }
 
@@ -60,6 +58,16 @@ Castro::fill_hybrid_hydro_source(MultiFab& sources, MultiFab& state)
 
 
 
+void
+Castro::hybrid_source_tile(const Box& bx, FArrayBox& state, FArrayBox& src)
+{
+  ca_hybrid_hydro_source(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+			 BL_TO_FORTRAN_3D(state),
+			 BL_TO_FORTRAN_3D(src));
+}
+
+
+
 void
 Castro::hybrid_sync(MultiFab& state)
 {
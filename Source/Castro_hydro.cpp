@@ -5,6 +5,10 @@
 #include "Radiation.H"
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace amrex;
 
 void
@@ -24,7 +28,8 @@ Castro::construct_hydro_source(Real time, Real dt)
     sources_for_hydro.setVal(0.0);
 
     for (int n = 0; n < num_src; ++n)
-	MultiFab::Add(sources_for_hydro, *old_sources[n], 0, 0, NUM_STATE, NUM_GROW);
+	if (source_flag(n))
+	    MultiFab::Add(sources_for_hydro, *old_sources[n], 0, 0, old_sources[n]->nComp(), NUM_GROW);
 
     sources_for_hydro.FillBoundary(geom.periodicity());
 
@@ -69,6 +74,11 @@ Castro::construct_hydro_source(Real time, Real dt)
     MultiFab& S_new = get_new_data(State_Type);
 
 #ifdef RADIATION
+    // The limiter is computed from the ghost zones of Sborder.
+
+    if (sborder_exchange_pending)
+      finish_state_exchange();
+
     MultiFab& Er_new = get_new_data(Rad_Type);
 
     if (!Radiation::rad_hydro_combined) {
@@ -99,192 +109,302 @@ Castro::construct_hydro_source(Real time, Real dt)
     Real yang_lost       = 0.;
     Real zang_lost       = 0.;
 
+    // Make sure the per-thread scratch space is available; this only
+    // allocates the first time through after a regrid.
+
+    build_hydro_scratch();
+
+    long scratch_reuses = 0;
+
+    // Number of (grown) zones passed through the primitive variable
+    // conversion, for the throughput report.
+
+    long prim_zones = 0;
+
+    const Real hydro_start_time = ParallelDescriptor::second();
+
     BL_PROFILE_VAR("Castro::advance_hydro_ca_umdrv()", CA_UMDRV);
 
+    // If the ghost zone exchange for Sborder is still outstanding, do
+    // the tiles that only need valid data first, then complete the
+    // exchange and do the remaining tiles.
+
+    const int nphase = sborder_exchange_pending ? 2 : 1;
+
+    long interior_zones = 0;
+
+    for (int phase = 0; phase < nphase; ++phase) {
+
+      if (phase == 1)
+	finish_state_exchange();
+
 #ifdef _OPENMP
 #ifdef RADIATION
-#pragma omp parallel
+#pragma omp parallel reduction(+:scratch_reuses,prim_zones,interior_zones)
 #else
 #pragma omp parallel reduction(+:mass_lost,xmom_lost,ymom_lost,zmom_lost) \
-		     reduction(+:eden_lost,xang_lost,yang_lost,zang_lost)
+		     reduction(+:eden_lost,xang_lost,yang_lost,zang_lost) \
+		     reduction(+:scratch_reuses,prim_zones,interior_zones)
 #endif
 #endif
-    {
+      {
 
-      FArrayBox flux[BL_SPACEDIM];
+#ifdef _OPENMP
+	HydroScratch& scratch = *hydro_scratch[omp_get_thread_num()];
+#else
+	HydroScratch& scratch = *hydro_scratch[0];
+#endif
+
+	FArrayBox* flux = scratch.flux;
 #if (BL_SPACEDIM <= 2)
-      FArrayBox pradial(Box::TheUnitBox(),1);
+	FArrayBox& pradial = scratch.pradial;
 #endif
 #ifdef RADIATION
-      FArrayBox rad_flux[BL_SPACEDIM];
+	FArrayBox* rad_flux = scratch.rad_flux;
 #endif
-      FArrayBox q, qaux, src_q;
+	FArrayBox& q = scratch.q;
+	FArrayBox& qaux = scratch.qaux;
+	FArrayBox& src_q = scratch.src_q;
 
-      int priv_nstep_fsp = -1;
+	int priv_nstep_fsp = -1;
 
-      Real cflLoc = -1.0e+200;
-      int is_finest_level = (level == finest_level) ? 1 : 0;
-      const int*  domain_lo = geom.Domain().loVect();
-      const int*  domain_hi = geom.Domain().hiVect();
+	Real cflLoc = -1.0e+200;
+	int is_finest_level = (level == finest_level) ? 1 : 0;
+	const int*  domain_lo = geom.Domain().loVect();
+	const int*  domain_hi = geom.Domain().hiVect();
 
-      for (MFIter mfi(S_new,hydro_tile_size); mfi.isValid(); ++mfi)
-      {
-	  const Box& bx    = mfi.tilebox();
-	  const Box& qbx = amrex::grow(bx, NUM_GROW);
+	for (MFIter mfi(S_new,hydro_tile_size); mfi.isValid(); ++mfi)
+	{
+	    const Box& bx    = mfi.tilebox();
+	    const Box& qbx = amrex::grow(bx, NUM_GROW);
 
-	  const int* lo = bx.loVect();
-	  const int* hi = bx.hiVect();
+	    // While the exchange is in flight, only work on tiles that
+	    // do not touch the ghost zones of Sborder.
 
-	  FArrayBox &statein  = Sborder[mfi];
-	  FArrayBox &stateout = S_new[mfi];
+	    const bool interior = mfi.validbox().contains(qbx);
 
-	  FArrayBox &source_in  = sources_for_hydro[mfi];
-	  FArrayBox &source_out = hydro_source[mfi];
+	    if (nphase == 2 && interior != (phase == 0)) continue;
+
+	    if (nphase == 2 && phase == 0)
+	      interior_zones += bx.numPts();
+
+	    FArrayBox &statein  = Sborder[mfi];
+	    FArrayBox &stateout = S_new[mfi];
+
+	    FArrayBox &source_in  = sources_for_hydro[mfi];
+	    FArrayBox &source_out = hydro_source[mfi];
 
 #ifdef RADIATION
-	  FArrayBox &Er = Erborder[mfi];
-	  FArrayBox &lam = lamborder[mfi];
-	  FArrayBox &Erout = Er_new[mfi];
+	    FArrayBox &Er = Erborder[mfi];
+	    FArrayBox &lam = lamborder[mfi];
+	    FArrayBox &Erout = Er_new[mfi];
+#endif
+
+	    const int idx = mfi.tileIndex();
+
+	    // Normally we do the whole tile at once. With hydro_fused_prim
+	    // we instead split the tile into slabs along prim_slab_dir, and
+	    // for each slab compute the primitive variables and their
+	    // sources on the slab grown by NUM_GROW and then immediately do
+	    // the CTU update of that slab, so that q, qaux and src_q are
+	    // still in cache when the reconstruction reads them. Every
+	    // kernel works on the box it is given, so this gives the same
+	    // result as using thinner tiles; the price is that the ghost
+	    // zones between slabs are converted twice.
+
+	    const int nslab = prim_slab_thickness(bx);
+
+	    for (int slo = bx.smallEnd(prim_slab_dir); slo <= bx.bigEnd(prim_slab_dir); slo += nslab) {
+
+		Box sbx(bx);
+		sbx.setSmall(prim_slab_dir, slo);
+		sbx.setBig(prim_slab_dir, std::min(slo + nslab - 1, bx.bigEnd(prim_slab_dir)));
+
+		const bool last_slab = sbx.bigEnd(prim_slab_dir) == bx.bigEnd(prim_slab_dir);
+
+		const int* lo = sbx.loVect();
+		const int* hi = sbx.hiVect();
+
+		const Box& qsbx = amrex::grow(sbx, NUM_GROW);
 
-	  q.resize(qbx, QRADVAR);
+#ifdef RADIATION
+		q.resize(qsbx, QRADVAR);
 #else
-	  q.resize(qbx, QVAR);
+		q.resize(qsbx, QVAR);
 #endif
-	  qaux.resize(qbx, NQAUX);
-	  src_q.resize(qbx, QVAR);
-
-	  // convert the conservative state to the primitive variable state.
-	  // this fills both q and qaux.
+		qaux.resize(qsbx, NQAUX);
+		src_q.resize(qsbx, QVAR);
 
-	  const int idx = mfi.tileIndex();
+		// convert the conservative state to the primitive variable state.
+		// this fills both q and qaux.
 
-	  ca_ctoprim(ARLIM_3D(qbx.loVect()), ARLIM_3D(qbx.hiVect()),
-		     statein.dataPtr(), ARLIM_3D(statein.loVect()), ARLIM_3D(statein.hiVect()),
+		ca_ctoprim(ARLIM_3D(qsbx.loVect()), ARLIM_3D(qsbx.hiVect()),
+			   statein.dataPtr(), ARLIM_3D(statein.loVect()), ARLIM_3D(statein.hiVect()),
 #ifdef RADIATION
-		     Er.dataPtr(), ARLIM_3D(Er.loVect()), ARLIM_3D(Er.hiVect()),
-		     lam.dataPtr(), ARLIM_3D(lam.loVect()), ARLIM_3D(lam.hiVect()),
+			   Er.dataPtr(), ARLIM_3D(Er.loVect()), ARLIM_3D(Er.hiVect()),
+			   lam.dataPtr(), ARLIM_3D(lam.loVect()), ARLIM_3D(lam.hiVect()),
 #endif
-		     q.dataPtr(), ARLIM_3D(q.loVect()), ARLIM_3D(q.hiVect()),
-		     qaux.dataPtr(), ARLIM_3D(qaux.loVect()), ARLIM_3D(qaux.hiVect()), &idx);
+			   q.dataPtr(), ARLIM_3D(q.loVect()), ARLIM_3D(q.hiVect()),
+			   qaux.dataPtr(), ARLIM_3D(qaux.loVect()), ARLIM_3D(qaux.hiVect()), &idx);
 
-	  // convert the source terms expressed as sources to the conserved state to those
-	  // expressed as sources for the primitive state.
+		// convert the source terms expressed as sources to the conserved state to those
+		// expressed as sources for the primitive state.
 
-	  ca_srctoprim(ARLIM_3D(qbx.loVect()), ARLIM_3D(qbx.hiVect()),
-		       q.dataPtr(), ARLIM_3D(q.loVect()), ARLIM_3D(q.hiVect()),
-		       qaux.dataPtr(), ARLIM_3D(qaux.loVect()), ARLIM_3D(qaux.hiVect()),
-		       source_in.dataPtr(), ARLIM_3D(source_in.loVect()), ARLIM_3D(source_in.hiVect()),
-		       src_q.dataPtr(), ARLIM_3D(src_q.loVect()), ARLIM_3D(src_q.hiVect()), &idx);
+		ca_srctoprim(ARLIM_3D(qsbx.loVect()), ARLIM_3D(qsbx.hiVect()),
+			     q.dataPtr(), ARLIM_3D(q.loVect()), ARLIM_3D(q.hiVect()),
+			     qaux.dataPtr(), ARLIM_3D(qaux.loVect()), ARLIM_3D(qaux.hiVect()),
+			     source_in.dataPtr(), ARLIM_3D(source_in.loVect()), ARLIM_3D(source_in.hiVect()),
+			     src_q.dataPtr(), ARLIM_3D(src_q.loVect()), ARLIM_3D(src_q.hiVect()), &idx);
 
 #ifndef RADIATION
 
-	  // Add in the reactions source term; only done in SDC.
+		// Add in the reactions source term; only done in SDC.
 
 #ifdef SDC
 #ifdef REACTIONS
-	  if (do_react)
-	    src_q.plus(SDC_react_source[mfi],qbx,qbx,0,0,QVAR);
+		if (do_react)
+		  src_q.plus(SDC_react_source[mfi],qsbx,qsbx,0,0,QVAR);
 #endif
 #endif
 #endif
-	  // Allocate fabs for fluxes
-	  for (int i = 0; i < BL_SPACEDIM ; i++)  {
-	    const Box& bxtmp = amrex::surroundingNodes(bx,i);
-	    flux[i].resize(bxtmp,NUM_STATE);
+
+		prim_zones += qsbx.numPts();
+
+		// Allocate fabs for fluxes
+		for (int i = 0; i < BL_SPACEDIM ; i++)  {
+		  const Box& bxtmp = amrex::surroundingNodes(sbx,i);
+		  flux[i].resize(bxtmp,NUM_STATE);
 #ifdef RADIATION
-	    rad_flux[i].resize(bxtmp,Radiation::nGroups);
+		  rad_flux[i].resize(bxtmp,Radiation::nGroups);
 #endif
-	  }
+		}
 
 #if (BL_SPACEDIM <= 2)
-	  if (!Geometry::IsCartesian()) {
-	    pradial.resize(amrex::surroundingNodes(bx,0),1);
-	  }
+		if (!Geometry::IsCartesian()) {
+		  pradial.resize(amrex::surroundingNodes(sbx,0),1);
+		}
 #endif
 
-	  ca_ctu_update
-	    (&is_finest_level, &time,
-	     lo, hi, domain_lo, domain_hi,
-	     BL_TO_FORTRAN_3D(statein), 
-	     BL_TO_FORTRAN_3D(stateout),
+		// Every resize above fits within the scratch allocation.
+
+		scratch_reuses += 3 + BL_SPACEDIM;
+
+		ca_ctu_update
+		  (&is_finest_level, &time,
+		   lo, hi, domain_lo, domain_hi,
+		   BL_TO_FORTRAN_3D(statein), 
+		   BL_TO_FORTRAN_3D(stateout),
 #ifdef RADIATION
-	     BL_TO_FORTRAN_3D(Er), 
-	     BL_TO_FORTRAN_3D(Erout),
-#endif
-	     BL_TO_FORTRAN_3D(q),
-	     BL_TO_FORTRAN_3D(qaux),
-	     BL_TO_FORTRAN_3D(src_q),
-	     BL_TO_FORTRAN_3D(source_out),
-	     dx, &dt,
-	     D_DECL(BL_TO_FORTRAN_3D(flux[0]),
-		    BL_TO_FORTRAN_3D(flux[1]),
-		    BL_TO_FORTRAN_3D(flux[2])),
+		   BL_TO_FORTRAN_3D(Er), 
+		   BL_TO_FORTRAN_3D(Erout),
+#endif
+		   BL_TO_FORTRAN_3D(q),
+		   BL_TO_FORTRAN_3D(qaux),
+		   BL_TO_FORTRAN_3D(src_q),
+		   BL_TO_FORTRAN_3D(source_out),
+		   dx, &dt,
+		   D_DECL(BL_TO_FORTRAN_3D(flux[0]),
+			  BL_TO_FORTRAN_3D(flux[1]),
+			  BL_TO_FORTRAN_3D(flux[2])),
 #ifdef RADIATION
-	     D_DECL(BL_TO_FORTRAN_3D(rad_flux[0]),
-		    BL_TO_FORTRAN_3D(rad_flux[1]),
-		    BL_TO_FORTRAN_3D(rad_flux[2])),
+		   D_DECL(BL_TO_FORTRAN_3D(rad_flux[0]),
+			  BL_TO_FORTRAN_3D(rad_flux[1]),
+			  BL_TO_FORTRAN_3D(rad_flux[2])),
 #endif
 #if (BL_SPACEDIM < 3)
-	     BL_TO_FORTRAN_3D(pradial),
+		   BL_TO_FORTRAN_3D(pradial),
 #endif
-	     D_DECL(BL_TO_FORTRAN_3D(area[0][mfi]),
-		    BL_TO_FORTRAN_3D(area[1][mfi]),
-		    BL_TO_FORTRAN_3D(area[2][mfi])),
+		   D_DECL(BL_TO_FORTRAN_3D(area[0][mfi]),
+			  BL_TO_FORTRAN_3D(area[1][mfi]),
+			  BL_TO_FORTRAN_3D(area[2][mfi])),
 #if (BL_SPACEDIM < 3)
-	     BL_TO_FORTRAN_3D(dLogArea[0][mfi]),
+		   BL_TO_FORTRAN_3D(dLogArea[0][mfi]),
 #endif
-	     BL_TO_FORTRAN_3D(volume[mfi]),
-	     &cflLoc, verbose,
+		   BL_TO_FORTRAN_3D(volume[mfi]),
+		   &cflLoc, verbose,
 #ifdef RADIATION
-	     &priv_nstep_fsp,
-#endif
-	     mass_lost, xmom_lost, ymom_lost, zmom_lost,
-	     eden_lost, xang_lost, yang_lost, zang_lost);
-
-	  // Store the fluxes from this advance.
-	  // For normal integration we want to add the fluxes from this advance
-	  // since we may be subcycling the timestep. But for SDC integration
-	  // we want to copy the fluxes since we expect that there will not be
-	  // subcycling and we only want the last iteration's fluxes.
-
-	  for (int i = 0; i < BL_SPACEDIM ; i++) {
+		   &priv_nstep_fsp,
+#endif
+		   mass_lost, xmom_lost, ymom_lost, zmom_lost,
+		   eden_lost, xang_lost, yang_lost, zang_lost);
+
+		// Store the fluxes from this advance.
+		// For normal integration we want to add the fluxes from this advance
+		// since we may be subcycling the timestep. But for SDC integration
+		// we want to copy the fluxes since we expect that there will not be
+		// subcycling and we only want the last iteration's fluxes.
+		// The face between two slabs is computed by both of them; it is
+		// stored by the upper one.
+
+		for (int i = 0; i < BL_SPACEDIM ; i++) {
+		  Box fbx = mfi.nodaltilebox(i) & amrex::surroundingNodes(sbx,i);
+		  if (i == prim_slab_dir && !last_slab)
+		    fbx.growHi(i, -1);
 #ifndef SDC
-	    (*fluxes    [i])[mfi].plus(    flux[i],mfi.nodaltilebox(i),0,0,NUM_STATE);
+		  fluxes[i][mfi].plus(flux[i],fbx,0,0,NUM_STATE);
 #ifdef RADIATION
-	    (*rad_fluxes[i])[mfi].plus(rad_flux[i],mfi.nodaltilebox(i),0,0,Radiation::nGroups);
+		  (*rad_fluxes[i])[mfi].plus(rad_flux[i],fbx,0,0,Radiation::nGroups);
 #endif
 #else
-	    (*fluxes    [i])[mfi].copy(    flux[i],mfi.nodaltilebox(i),0,mfi.nodaltilebox(i),0,NUM_STATE);
+		  fluxes[i][mfi].copy(flux[i],fbx,0,fbx,0,NUM_STATE);
 #ifdef RADIATION
-	    (*rad_fluxes[i])[mfi].copy(rad_flux[i],mfi.nodaltilebox(i),0,mfi.nodaltilebox(i),0,Radiation::nGroups);
+		  (*rad_fluxes[i])[mfi].copy(rad_flux[i],fbx,0,fbx,0,Radiation::nGroups);
 #endif	    
 #endif
-	  }
+		}
 
 #if (BL_SPACEDIM <= 2)
-	  if (!Geometry::IsCartesian()) {
+		if (!Geometry::IsCartesian()) {
+		  Box fbx = mfi.nodaltilebox(0) & amrex::surroundingNodes(sbx,0);
+		  if (prim_slab_dir == 0 && !last_slab)
+		    fbx.growHi(0, -1);
 #ifndef SDC
-	    P_radial[mfi].plus(pradial,mfi.nodaltilebox(0),0,0,1);
+		  P_radial[mfi].plus(pradial,fbx,0,0,1);
 #else
-	    P_radial[mfi].copy(pradial,mfi.nodaltilebox(0),0,mfi.nodaltilebox(0),0,1);
+		  P_radial[mfi].copy(pradial,fbx,0,fbx,0,1);
 #endif
-	  }
+		}
 #endif
-      } // MFIter loop
+
+	    } // slab loop
+	} // MFIter loop
 
 #ifdef _OPENMP
 #pragma omp critical (hydro_courno)
 #endif
-      {
-	courno = std::max(courno,cflLoc);
+	{
+	  courno = std::max(courno,cflLoc);
 #ifdef RADIATION
-	nstep_fsp = std::max(nstep_fsp, priv_nstep_fsp);
+	  nstep_fsp = std::max(nstep_fsp, priv_nstep_fsp);
 #endif
-      }
-    }  // end of omp parallel region
+	}
+      }  // end of omp parallel region
+
+    } // phase loop
 
     BL_PROFILE_VAR_STOP(CA_UMDRV);
 
+    if (hydro_throughput_report)
+        print_hydro_throughput(prim_zones, ParallelDescriptor::second() - hydro_start_time);
+
+    if (verbose && nphase == 2) {
+
+      long zones[2] = {interior_zones, static_cast<long>(grids.numPts())};
+
+#ifdef BL_LAZY
+      Lazy::QueueReduction( [=] () mutable {
+#endif
+	ParallelDescriptor::ReduceLongSum(zones, 2, ParallelDescriptor::IOProcessorNumber());
+
+	if (ParallelDescriptor::IOProcessor())
+	  std::cout << "... fraction of zones advanced during the ghost zone exchange: "
+		    << static_cast<Real>(zones[0]) / static_cast<Real>(zones[1]) << std::endl;
+#ifdef BL_LAZY
+      });
+#endif
+
+    }
+
 #ifdef RADIATION
     if (radiation->verbose>=1) {
 #ifdef BL_LAZY
@@ -351,6 +471,9 @@ Castro::construct_hydro_source(Real time, Real dt)
 	  amrex::Abort("CFL is too high at this level -- go back to a checkpoint and restart with lower cfl number");
     }
 
+    if (verbose)
+        print_hydro_scratch_usage(scratch_reuses);
+
     if (verbose && ParallelDescriptor::IOProcessor())
         std::cout << std::endl << "... Leaving hydro advance" << std::endl << std::endl;
 
@@ -383,7 +506,8 @@ Castro::construct_mol_hydro_source(Real time, Real dt)
   sources_for_hydro.setVal(0.0);
 
   for (int n = 0; n < num_src; ++n)
-    MultiFab::Add(sources_for_hydro, *old_sources[n], 0, 0, NUM_STATE, 0);
+    if (source_flag(n))
+      MultiFab::Add(sources_for_hydro, *old_sources[n], 0, 0, old_sources[n]->nComp(), 0);
 
   int finest_level = parent->finestLevel();
 
@@ -415,21 +539,32 @@ Castro::construct_mol_hydro_source(Real time, Real dt)
   int nstep_fsp = -1;
 #endif
 
+  build_hydro_scratch();
+
+  long scratch_reuses = 0;
+
   BL_PROFILE_VAR("Castro::advance_hydro_ca_umdrv()", CA_UMDRV);
 
 #ifdef _OPENMP
-#pragma omp parallel
+#pragma omp parallel reduction(+:scratch_reuses)
 #endif
   {
 
-    FArrayBox flux[BL_SPACEDIM];
+#ifdef _OPENMP
+    HydroScratch& scratch = *hydro_scratch[omp_get_thread_num()];
+#else
+    HydroScratch& scratch = *hydro_scratch[0];
+#endif
+
+    FArrayBox* flux = scratch.flux;
 #if (BL_SPACEDIM <= 2)
-    FArrayBox pradial(Box::TheUnitBox(),1);
+    FArrayBox& pradial = scratch.pradial;
 #endif
 #ifdef RADIATION
-    FArrayBox rad_flux[BL_SPACEDIM];
+    FArrayBox* rad_flux = scratch.rad_flux;
 #endif
-    FArrayBox q, qaux;
+    FArrayBox& q = scratch.q;
+    FArrayBox& qaux = scratch.qaux;
 
     int priv_nstep_fsp = -1;
 
@@ -499,7 +634,9 @@ Castro::construct_mol_hydro_source(Real time, Real dt)
 	  pradial.resize(amrex::surroundingNodes(bx,0),1);
 	}
 #endif
-	  
+
+	scratch_reuses += 2 + BL_SPACEDIM;
+
 	ca_mol_single_stage
 	  (&time,
 	   lo, hi, domain_lo, domain_hi,
@@ -530,7 +667,7 @@ Castro::construct_mol_hydro_source(Real time, Real dt)
 	// Store the fluxes from this advance -- we weight them by the
 	// integrator weight for this stage
 	for (int i = 0; i < BL_SPACEDIM ; i++) {
-	  (*fluxes    [i])[mfi].saxpy(b_mol[mol_iteration], flux[i], 
+	  fluxes[i][mfi].saxpy(b_mol[mol_iteration], flux[i], 
 				      mfi.nodaltilebox(i), mfi.nodaltilebox(i), 0, 0, NUM_STATE);
 #ifdef RADIATION
 	  (*rad_fluxes[i])[mfi].saxpy(b_mol[mol_iteration], rad_flux[i], 
@@ -560,9 +697,10 @@ Castro::construct_mol_hydro_source(Real time, Real dt)
 
   // Flush Fortran output
 
-  if (verbose)
+  if (verbose) {
     flush_output();
-
+    print_hydro_scratch_usage(scratch_reuses);
+  }
 
   if (print_update_diagnostics)
     {
@@ -593,3 +731,202 @@ Castro::construct_mol_hydro_source(Real time, Real dt)
   }
 
 }
+
+
+
+void
+Castro::build_hydro_scratch()
+{
+
+  // Allocate one set of hydro scratch FABs per thread, large enough
+  // to hold the grown version of the largest tile on this level.
+  // FArrayBox::resize only reallocates when the requested size
+  // exceeds what is already allocated, so the tile loops can then
+  // resize these freely without touching the heap.
+
+  if (!hydro_scratch.empty()) return;
+
+  BL_PROFILE("Castro::build_hydro_scratch()");
+
+  MultiFab& S_new = get_new_data(State_Type);
+
+  IntVect max_len = IntVect::TheZeroVector();
+
+  for (MFIter mfi(S_new, hydro_tile_size); mfi.isValid(); ++mfi)
+    max_len.max(mfi.tilebox().size());
+
+  // If nothing lives on this processor we still create the (empty)
+  // per-thread entries so that the tile loops can index them.
+
+  const bool have_tiles = (max_len != IntVect::TheZeroVector());
+
+  const Box bx(IntVect::TheZeroVector(), max_len - IntVect::TheUnitVector());
+  const Box qbx = amrex::grow(bx, NUM_GROW);
+
+#ifdef _OPENMP
+  const int nthreads = omp_get_max_threads();
+#else
+  const int nthreads = 1;
+#endif
+
+  hydro_scratch.resize(nthreads);
+
+  for (int t = 0; t < nthreads; ++t) {
+
+    hydro_scratch[t].reset(new HydroScratch);
+
+    if (!have_tiles) continue;
+
+    HydroScratch& scratch = *hydro_scratch[t];
+
+#ifdef RADIATION
+    scratch.q.resize(qbx, QRADVAR);
+#else
+    scratch.q.resize(qbx, QVAR);
+#endif
+    scratch.qaux.resize(qbx, NQAUX);
+    hydro_scratch_allocs += 2;
+
+    if (do_ctu) {
+      scratch.src_q.resize(qbx, QVAR);
+      hydro_scratch_allocs += 1;
+    }
+
+    for (int i = 0; i < BL_SPACEDIM; ++i) {
+      const Box& bxtmp = amrex::surroundingNodes(bx,i);
+      scratch.flux[i].resize(bxtmp, NUM_STATE);
+      hydro_scratch_allocs += 1;
+#ifdef RADIATION
+      scratch.rad_flux[i].resize(bxtmp, Radiation::nGroups);
+      hydro_scratch_allocs += 1;
+#endif
+    }
+
+#if (BL_SPACEDIM <= 2)
+    if (!Geometry::IsCartesian()) {
+      scratch.pradial.resize(amrex::surroundingNodes(bx,0),1);
+    } else {
+      scratch.pradial.resize(Box::TheUnitBox(),1);
+    }
+    hydro_scratch_allocs += 1;
+#endif
+
+  }
+
+}
+
+
+
+void
+Castro::clear_hydro_scratch()
+{
+  hydro_scratch.clear();
+}
+
+
+
+void
+Castro::print_hydro_scratch_usage(long scratch_reuses)
+{
+
+  // Report how many per-tile FAB allocations were avoided by reusing
+  // the scratch space, and how many allocations it took to build it.
+
+  long allocs = hydro_scratch_allocs;
+
+  hydro_scratch_allocs = 0;
+
+#ifdef BL_LAZY
+  Lazy::QueueReduction( [=] () mutable {
+#endif
+      long counts[2] = {scratch_reuses, allocs};
+
+      ParallelDescriptor::ReduceLongSum(counts, 2, ParallelDescriptor::IOProcessorNumber());
+
+      if (ParallelDescriptor::IOProcessor())
+	std::cout << "... hydro scratch on level " << level << ": "
+		  << counts[0] << " tile allocations saved, "
+		  << counts[1] << " scratch FABs allocated" << std::endl;
+
+#ifdef BL_LAZY
+    });
+#endif
+
+}
+
+
+
+int
+Castro::prim_slab_thickness(const Box& bx)
+{
+
+  // The number of cells along prim_slab_dir in each slab of the tile bx
+  // for the fused primitive variable conversion and CTU update.  Each
+  // slab works on itself grown by NUM_GROW, and each zone of that
+  // touches the conserved state and its source (NUM_STATE each), q,
+  // qaux and src_q.
+
+  const int len = bx.length(prim_slab_dir);
+
+  if (!hydro_fused_prim)
+    return len;
+
+#ifdef RADIATION
+  const long bytes_per_zone = sizeof(Real) * (2 * NUM_STATE + QRADVAR + NQAUX + QVAR);
+#else
+  const long bytes_per_zone = sizeof(Real) * (2 * NUM_STATE + QVAR + NQAUX + QVAR);
+#endif
+
+  const Box& qbx = amrex::grow(bx, NUM_GROW);
+
+  const long bytes_per_slab = bytes_per_zone * (qbx.numPts() / qbx.length(prim_slab_dir));
+
+  const long nslab = hydro_fused_block_bytes / bytes_per_slab - 2 * NUM_GROW;
+
+  return std::max(1L, std::min(nslab, static_cast<long>(len)));
+
+}
+
+
+
+void
+Castro::print_hydro_throughput(long prim_zones, Real run_time)
+{
+
+  // Report the zones/sec of the CTU hydro update on this level, along
+  // with an estimate of the bytes moved through the state, q, qaux and
+  // src_q for the zones that went through the primitive variable
+  // conversion.  With hydro_fused_prim this count includes the ghost
+  // zones that are converted once per slab.
+
+#ifdef RADIATION
+  const long nq = QRADVAR;
+#else
+  const long nq = QVAR;
+#endif
+
+  const long bytes_per_zone = sizeof(Real) * (NUM_STATE + nq + NQAUX + QVAR);
+
+  const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+  long zones = grids.numPts();
+
+#ifdef BL_LAZY
+  Lazy::QueueReduction( [=] () mutable {
+#endif
+      ParallelDescriptor::ReduceRealMax(run_time, IOProc);
+      ParallelDescriptor::ReduceLongSum(prim_zones, IOProc);
+
+      if (ParallelDescriptor::IOProcessor()) {
+	const Real bytes = static_cast<Real>(prim_zones) * bytes_per_zone;
+	std::cout << "... hydro on level " << level
+		  << (hydro_fused_prim ? " (fused)" : "") << ": "
+		  << zones / run_time << " zones/sec, "
+		  << prim_zones << " zones converted to primitive variables, ~"
+		  << bytes / 1.e9 << " GB of state, q, qaux and src_q" << std::endl;
+      }
+#ifdef BL_LAZY
+    });
+#endif
+
+}
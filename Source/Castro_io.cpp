@@ -5,6 +5,9 @@
 
 #include <iomanip>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <limits>
 #include <string>
 #include <ctime>
 
@@ -12,6 +15,7 @@
 #include "Castro.H"
 #include "Castro_F.H"
 #include "Castro_io.H"
+#include "Castro_async_io.H"
 #include <AMReX_ParmParse.H>
 
 #ifdef RADIATION
@@ -30,6 +34,10 @@
 #include <omp.h>
 #endif
 
+#ifdef CASTRO_ZLIB
+#include <zlib.h>
+#endif
+
 
 #include "AMReX_buildInfo.H"
 
@@ -48,11 +56,206 @@ using namespace amrex;
 // 3: A ReactHeader file was generated and the maximum de/dt was stored there
 // 4: Reactions_Type added to checkpoint; ReactHeader functionality deprecated
 // 5: SDC_Source_Type and SDC_React_Type added to checkpoint
+// 6: CastroHeader records whether the state data is compressed and
+//    whether the derived state types were left out
 
 namespace
 {
     int input_version = -1;
-    int current_version = 5;
+    int current_version = 6;
+
+    int input_compressed = 0;
+    int input_dropped = 0;
+
+    // State types that are rebuilt during the evolution and so may be
+    // left out of a checkpoint with castro.checkpoint_drop_derived.
+
+    bool is_derived_state (int typ)
+    {
+	if (typ == Source_Type) return true;
+#ifdef REACTIONS
+	if (typ == Reactions_Type) return true;
+#endif
+	return false;
+    }
+
+#ifdef CASTRO_ZLIB
+
+    // Each FAB is stored byte-shuffled -- all of the first bytes of its
+    // values, then all of the second bytes, and so on -- so that the
+    // slowly varying sign and exponent bytes end up next to each other,
+    // and then deflated.
+
+    void shuffle_and_deflate (const FArrayBox& fab, int clevel, std::string& out)
+    {
+	const size_t w = sizeof(Real);
+	const size_t n = fab.box().numPts() * fab.nComp();
+	const char* src = reinterpret_cast<const char*>(fab.dataPtr());
+
+	std::string shuffled(n*w, '\0');
+	for (size_t b = 0; b < w; b++)
+	    for (size_t k = 0; k < n; k++)
+		shuffled[b*n+k] = src[k*w+b];
+
+	uLongf zlen = compressBound(shuffled.size());
+	out.resize(zlen);
+
+	if (compress2(reinterpret_cast<Bytef*>(&out[0]), &zlen,
+		      reinterpret_cast<const Bytef*>(shuffled.data()), shuffled.size(),
+		      clevel) != Z_OK)
+	    amrex::Abort("Castro: compression of checkpoint data failed");
+
+	out.resize(zlen);
+    }
+
+    void inflate_and_unshuffle (const std::string& in, FArrayBox& fab)
+    {
+	const size_t w = sizeof(Real);
+	const size_t n = fab.box().numPts() * fab.nComp();
+	char* dst = reinterpret_cast<char*>(fab.dataPtr());
+
+	std::string shuffled(n*w, '\0');
+
+	uLongf len = shuffled.size();
+	if (uncompress(reinterpret_cast<Bytef*>(&shuffled[0]), &len,
+		       reinterpret_cast<const Bytef*>(in.data()), in.size()) != Z_OK ||
+	    len != shuffled.size())
+	    amrex::Abort("Castro: compressed checkpoint data is corrupt or does not match the grids");
+
+	for (size_t b = 0; b < w; b++)
+	    for (size_t k = 0; k < n; k++)
+		dst[k*w+b] = shuffled[b*n+k];
+    }
+
+    //
+    // Write a MultiFab as one compressed record per FAB. Each processor
+    // compresses its own FABs (threaded) and writes them to its own data
+    // file; the I/O processor writes a header with the owner, offset and
+    // length of every record.
+    //
+    void write_compressed_mf (const MultiFab& mf, const std::string& name, int clevel)
+    {
+	const int nboxes = mf.size();
+	const int MyProc = ParallelDescriptor::MyProc();
+	const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+	std::vector<int> local;
+	for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+	    local.push_back(mfi.index());
+
+	const int nlocal = local.size();
+	std::vector<std::string> zdata(nlocal);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int k = 0; k < nlocal; k++)
+	    shuffle_and_deflate(mf[local[k]], clevel, zdata[k]);
+
+	Array<long> offset(nboxes, 0);
+	Array<long> nbytes(nboxes, 0);
+
+	if (nlocal > 0) {
+
+	    std::string FullPathData = amrex::Concatenate(name + "_D_", MyProc, 5);
+
+	    std::ofstream data(FullPathData.c_str(), std::ios::out | std::ios::binary);
+	    if (!data.good())
+		amrex::FileOpenFailed(FullPathData);
+
+	    long pos = 0;
+	    for (int k = 0; k < nlocal; k++) {
+		data.write(zdata[k].data(), zdata[k].size());
+		offset[local[k]] = pos;
+		nbytes[local[k]] = zdata[k].size();
+		pos += zdata[k].size();
+	    }
+
+	    if (!data.good())
+		amrex::Abort(("Castro: failed writing " + FullPathData).c_str());
+
+	}
+
+	ParallelDescriptor::ReduceLongSum(offset.dataPtr(), nboxes, IOProc);
+	ParallelDescriptor::ReduceLongSum(nbytes.dataPtr(), nboxes, IOProc);
+
+	if (ParallelDescriptor::IOProcessor()) {
+
+	    std::string FullPathHeader = name + "_H";
+
+	    std::ofstream hdr(FullPathHeader.c_str(), std::ios::out);
+
+	    hdr << "shuffle-deflate " << sizeof(Real) << '\n';
+	    hdr << mf.nComp() << ' ' << mf.nGrow() << '\n';
+	    hdr << nboxes << '\n';
+	    for (int i = 0; i < nboxes; i++)
+		hdr << mf.DistributionMap()[i] << ' ' << offset[i] << ' ' << nbytes[i] << '\n';
+
+	    if (!hdr.good())
+		amrex::FileOpenFailed(FullPathHeader);
+
+	}
+    }
+
+    //
+    // Read a MultiFab written by write_compressed_mf. The MultiFab must
+    // already be defined on the grids it was written from, but it may be
+    // distributed differently.
+    //
+    void read_compressed_mf (MultiFab& mf, const std::string& name)
+    {
+	Array<char> header;
+	ParallelDescriptor::ReadAndBcastFile(name + "_H", header);
+	std::istringstream hdr(std::string(header.dataPtr()), std::istringstream::in);
+
+	std::string codec;
+	int wordsize, ncomp, ngrow, nboxes;
+	hdr >> codec >> wordsize >> ncomp >> ngrow >> nboxes;
+
+	if (codec != "shuffle-deflate" || wordsize != int(sizeof(Real)) ||
+	    ncomp != mf.nComp() || ngrow != mf.nGrow() || nboxes != mf.size())
+	    amrex::Abort(("Castro: compressed checkpoint data " + name + " does not match the state it is read into").c_str());
+
+	Array<int>  owner(nboxes);
+	Array<long> offset(nboxes);
+	Array<long> nbytes(nboxes);
+	for (int i = 0; i < nboxes; i++)
+	    hdr >> owner[i] >> offset[i] >> nbytes[i];
+
+	std::vector<int> local;
+	for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+	    local.push_back(mfi.index());
+
+	const int nlocal = local.size();
+	std::vector<std::string> zdata(nlocal);
+
+	for (int k = 0; k < nlocal; k++) {
+
+	    const int i = local[k];
+
+	    std::string FullPathData = amrex::Concatenate(name + "_D_", owner[i], 5);
+
+	    std::ifstream data(FullPathData.c_str(), std::ios::in | std::ios::binary);
+	    if (!data.good())
+		amrex::FileOpenFailed(FullPathData);
+
+	    zdata[k].resize(nbytes[i]);
+	    data.seekg(offset[i], std::ios::beg);
+	    data.read(&zdata[k][0], nbytes[i]);
+
+	    if (!data.good())
+		amrex::Abort(("Castro: failed reading " + FullPathData).c_str());
+
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int k = 0; k < nlocal; k++)
+	    inflate_and_unshuffle(zdata[k], mf[local[k]]);
+    }
+
+#endif
 }
 
 // I/O routines for Castro
@@ -75,12 +278,20 @@ Castro::restart (Amr&     papa,
 		// first line: Checkpoint version: ?
 		CastroHeaderFile.getline(foo, 256, ':');  
 		CastroHeaderFile >> input_version;
+		if (input_version >= 6) {
+		    CastroHeaderFile.getline(foo, 256, ':');
+		    CastroHeaderFile >> input_compressed;
+		    CastroHeaderFile.getline(foo, 256, ':');
+		    CastroHeaderFile >> input_dropped;
+		}
    		CastroHeaderFile.close();
   	    } else {
    		input_version = 0;
    	    }
    	}
   	ParallelDescriptor::Bcast(&input_version, 1, ParallelDescriptor::IOProcessorNumber());
+  	ParallelDescriptor::Bcast(&input_compressed, 1, ParallelDescriptor::IOProcessorNumber());
+  	ParallelDescriptor::Bcast(&input_dropped, 1, ParallelDescriptor::IOProcessorNumber());
     }
  
     BL_ASSERT(input_version >= 0);
@@ -89,6 +300,16 @@ Castro::restart (Amr&     papa,
 
     AmrLevel::restart(papa,is,bReadSpecial);
 
+    if (input_compressed) {
+      restartCompressedState(papa.theRestartFile(), is);
+    }
+
+    if (input_dropped) {
+      for (int i = 0; i < num_state_type; ++i)
+	if (is_derived_state(i))
+	  state[i].restart(desc_lst[i], state[State_Type]);
+    }
+
     if (input_version == 0) { // old checkpoint without PhiGrav_Type
 #ifdef SELF_GRAVITY
       state[PhiGrav_Type].restart(desc_lst[PhiGrav_Type], state[Gravity_Type]);
@@ -438,6 +659,14 @@ Castro::set_state_in_checkpoint (Array<int>& state_in_checkpoint)
     }
 #endif
 #endif
+    if (input_compressed) {
+      // The state data follows the level header in its own format
+      state_in_checkpoint[i] = 0;
+    }
+    if (input_dropped && is_derived_state(i)) {
+      // This type was left out of the checkpoint
+      state_in_checkpoint[i] = 0;
+    }
   }
 }
 
@@ -447,7 +676,10 @@ Castro::checkPoint(const std::string& dir,
                    VisMF::How     how,
                    bool dump_old_default)
 {
-  AmrLevel::checkPoint(dir, os, how, dump_old);
+  if (checkpoint_compress || checkpoint_drop_derived)
+    checkPointState(dir, os, how);
+  else
+    AmrLevel::checkPoint(dir, os, how, dump_old);
 
 #ifdef RADIATION
   if (do_radiation) {
@@ -468,6 +700,8 @@ Castro::checkPoint(const std::string& dir,
 	    CastroHeaderFile.open(FullPathCastroHeaderFile.c_str(), std::ios::out);
 
 	    CastroHeaderFile << "Checkpoint version: " << current_version << std::endl;
+	    CastroHeaderFile << "Compressed state: " << checkpoint_compress << std::endl;
+	    CastroHeaderFile << "Dropped derived state: " << checkpoint_drop_derived << std::endl;
 	    CastroHeaderFile.close();
 	}
 
@@ -517,6 +751,140 @@ Castro::checkPoint(const std::string& dir,
 
 }
 
+void
+Castro::checkPointState (const std::string& dir,
+                         std::ostream&      os,
+                         VisMF::How         how)
+{
+    // This writes the same level header as AmrLevel::checkPoint, but
+    // the state types that are compressed or left out are not counted
+    // in it; set_state_in_checkpoint tells AmrLevel::restart which of
+    // the types it will find.
+
+#ifndef CASTRO_ZLIB
+    if (checkpoint_compress)
+	amrex::Abort("castro.checkpoint_compress requires building with USE_ZLIB = TRUE");
+#endif
+
+    char buf[64];
+    sprintf(buf, "Level_%d", level);
+    std::string Level = buf;
+
+    std::string FullPath = dir;
+    if (!FullPath.empty() && FullPath[FullPath.size()-1] != '/')
+        FullPath += '/';
+    FullPath += Level;
+
+    if (ParallelDescriptor::IOProcessor())
+        if (!amrex::UtilCreateDirectory(FullPath, 0755))
+            amrex::CreateDirectoryFailed(FullPath);
+
+    ParallelDescriptor::Barrier();
+
+    Array<int> write_state(num_state_type, 1);
+    if (checkpoint_drop_derived)
+	for (int i = 0; i < num_state_type; ++i)
+	    if (is_derived_state(i))
+		write_state[i] = 0;
+
+    int nstate = 0;
+    if (!checkpoint_compress)
+	for (int i = 0; i < num_state_type; ++i)
+	    nstate += write_state[i];
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        os << level << '\n' << geom  << '\n';
+        grids.writeOn(os);
+        os << nstate << '\n';
+    }
+
+    if (!checkpoint_compress)
+    {
+	for (int i = 0; i < num_state_type; ++i)
+	{
+	    if (!write_state[i]) continue;
+
+	    std::string PathNameInHdr = amrex::Concatenate(Level + "/SD_", i, 1);
+	    std::string FullPathName  = amrex::Concatenate(FullPath + "/SD_", i, 1);
+
+	    state[i].checkPoint(PathNameInHdr, FullPathName, os, how, dump_old);
+	}
+	return;
+    }
+
+#ifdef CASTRO_ZLIB
+    int ncompressed = 0;
+    for (int i = 0; i < num_state_type; ++i)
+	ncompressed += write_state[i];
+
+    if (ParallelDescriptor::IOProcessor())
+	os << "CompressedState " << ncompressed << '\n';
+
+    for (int i = 0; i < num_state_type; ++i)
+    {
+	if (!write_state[i]) continue;
+
+	const bool write_old = dump_old && state[i].hasOldData();
+
+	std::string PathNameInHdr = amrex::Concatenate(Level + "/SD_", i, 1);
+	std::string FullPathName  = amrex::Concatenate(FullPath + "/SD_", i, 1);
+
+	if (ParallelDescriptor::IOProcessor())
+	{
+	    int oldprec = os.precision(17);
+	    os << i << ' ' << (write_old ? 2 : 1) << ' '
+	       << state[i].curTime() << ' ' << state[i].prevTime() << '\n';
+	    os << PathNameInHdr << "_New_Z" << '\n';
+	    if (write_old)
+		os << PathNameInHdr << "_Old_Z" << '\n';
+	    os.precision(oldprec);
+	}
+
+	write_compressed_mf(state[i].newData(), FullPathName + "_New_Z", checkpoint_compress_level);
+	if (write_old)
+	    write_compressed_mf(state[i].oldData(), FullPathName + "_Old_Z", checkpoint_compress_level);
+    }
+#endif
+}
+
+void
+Castro::restartCompressedState (const std::string& restart_file,
+                                istream&           is)
+{
+#ifndef CASTRO_ZLIB
+    amrex::Abort("Restarting from a compressed checkpoint requires building with USE_ZLIB = TRUE");
+#else
+    std::string tag;
+    int ncompressed;
+    is >> tag >> ncompressed;
+
+    if (tag != "CompressedState")
+	amrex::Abort("Castro::restartCompressedState: compressed state not found in the checkpoint header");
+
+    for (int n = 0; n < ncompressed; ++n)
+    {
+	int typ, nmf;
+	Real new_time, old_time;
+	is >> typ >> nmf >> new_time >> old_time;
+
+	state[typ].define(geom.Domain(), grids, dmap, desc_lst[typ], new_time, new_time - old_time);
+	state[typ].setNewTimeLevel(new_time);
+	state[typ].setOldTimeLevel(old_time);
+
+	std::string name;
+	is >> name;
+	read_compressed_mf(state[typ].newData(), restart_file + "/" + name);
+
+	if (nmf == 2) {
+	    state[typ].allocOldData();
+	    is >> name;
+	    read_compressed_mf(state[typ].oldData(), restart_file + "/" + name);
+	}
+    }
+#endif
+}
+
 std::string
 Castro::thePlotFileType () const
 {
@@ -826,6 +1194,12 @@ Castro::writePlotFile (const std::string& dir,
   ParticlePlotFile(dir);
 #endif
 
+    if (async_plotfile && level == 0) {
+	if (async_plot_writer == 0)
+	    async_plot_writer = new AsyncPlotWriter(async_plotfile_queue);
+	async_plot_writer->begin(dir);
+    }
+
     int i, n;
     //
     // The list of indices of State to write to plotfile.
@@ -1046,7 +1420,92 @@ Castro::writePlotFile (const std::string& dir,
     //
     std::string TheFullPath = FullPath;
     TheFullPath += BaseName;
-    VisMF::Write(plotMF,TheFullPath,how,true);
+    if (async_plotfile)
+	writePlotFileDataAsync(plotMF,TheFullPath,how);
+    else
+	VisMF::Write(plotMF,TheFullPath,how,true);
+}
+
+void
+Castro::writePlotFileDataAsync (const MultiFab&    plotMF,
+                                const std::string& name,
+                                VisMF::How         how)
+{
+    BL_PROFILE("Castro::writePlotFileDataAsync()");
+
+    // This writes the same layout as VisMF::Write with one file per
+    // fab: the header is assembled and written here, and the fabs are
+    // serialized into memory and handed to the background writer.
+
+    const BoxArray& ba = plotMF.boxArray();
+    const int nboxes = ba.size();
+    const int ncomp  = plotMF.nComp();
+
+    Array<Real> fab_min(nboxes*ncomp,  std::numeric_limits<Real>::max());
+    Array<Real> fab_max(nboxes*ncomp, -std::numeric_limits<Real>::max());
+
+    for (MFIter mfi(plotMF); mfi.isValid(); ++mfi)
+    {
+	const int i = mfi.index();
+	const FArrayBox& fab = plotMF[mfi];
+
+	for (int n = 0; n < ncomp; n++) {
+	    fab_min[i*ncomp+n] = fab.min(mfi.validbox(),n);
+	    fab_max[i*ncomp+n] = fab.max(mfi.validbox(),n);
+	}
+
+	std::ostringstream fab_data;
+	fab.writeOn(fab_data);
+
+	std::string data = fab_data.str();
+	async_plot_writer->add(amrex::Concatenate(name + "_D_", i, 5), data);
+    }
+
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    ParallelDescriptor::ReduceRealMin(fab_min.dataPtr(), fab_min.size(), IOProc);
+    ParallelDescriptor::ReduceRealMax(fab_max.dataPtr(), fab_max.size(), IOProc);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+	std::string base = name.substr(name.rfind('/')+1);
+
+	std::ofstream hdr((name + "_H").c_str());
+
+	hdr.setf(std::ios::floatfield, std::ios::scientific);
+	hdr.precision(15);
+
+	hdr << 1 << '\n';  // VisMF::Header::Version_v1
+	hdr << int(how) << '\n';
+	hdr << ncomp << '\n';
+	hdr << plotMF.nGrow() << '\n';
+	ba.writeOn(hdr);
+	hdr << '\n';
+
+	hdr << nboxes << '\n';
+	for (int i = 0; i < nboxes; i++)
+	    hdr << "FabOnDisk: " << amrex::Concatenate(base + "_D_", i, 5) << ' ' << 0 << '\n';
+	hdr << '\n';
+
+	hdr << nboxes << ',' << ncomp << '\n';
+	for (int i = 0; i < nboxes; i++) {
+	    for (int n = 0; n < ncomp; n++)
+		hdr << fab_min[i*ncomp+n] << ',';
+	    hdr << '\n';
+	}
+	hdr << '\n';
+
+	hdr << nboxes << ',' << ncomp << '\n';
+	for (int i = 0; i < nboxes; i++) {
+	    for (int n = 0; n < ncomp; n++)
+		hdr << fab_max[i*ncomp+n] << ',';
+	    hdr << '\n';
+	}
+	hdr << '\n';
+
+	if (!hdr.good())
+	    amrex::FileOpenFailed(name + "_H");
+    }
 }
 
 void
@@ -4,6 +4,8 @@
 
 #include "AMReX_DistributionMapping.H"
 
+#include <algorithm>
+
 using std::string;
 using namespace amrex;
 
@@ -21,12 +23,15 @@ Castro::strang_react_first_half(Real time, Real dt)
 
     if (do_react != 1) return;
 
+    // We burn on the ghost zones of Sborder, so they must be filled.
+
+    if (sborder_exchange_pending)
+	finish_state_exchange();
+
     // Get the current state data.
 
     MultiFab& state = Sborder;
 
-    const int ng = state.nGrow();
-
     // Reactions are expensive and we would usually rather do a
     // communication step than burn on the ghost zones. So what we
     // will do here is create a mask that indicates that we want to
@@ -37,19 +42,63 @@ Castro::strang_react_first_half(Real time, Real dt)
     // coarse zones. So we will not mask out those zones, and the
     // subsequent FillBoundary call will not interfere with it.
 
-    iMultiFab& interior_mask = build_interior_boundary_mask(ng);
+    const int ng = state.nGrow();
+
+    MultiFab* weights = use_custom_knapsack_weights ? &get_old_data(Knapsack_Weight_Type) : nullptr;
+
+    strang_react(state, reactions, weights, time, dt, ng);
+
+}
+
+
+
+void
+Castro::strang_react_second_half(Real time, Real dt)
+{
+
+    MultiFab& reactions = get_new_data(Reactions_Type);
+
+    reactions.setVal(0.0);
+
+    if (do_react != 1) return;
+
+    MultiFab& state = get_new_data(State_Type);
+
+    // To be consistent with other source term types,
+    // we are only applying this on the interior zones.
+
+    const int ng = 0;
+
+    MultiFab* weights = use_custom_knapsack_weights ? &get_new_data(Knapsack_Weight_Type) : nullptr;
+
+    strang_react(state, reactions, weights, time, dt, ng);
+
+}
+
 
-    // The reaction weightings.
 
-    MultiFab* weights;
+// Burn state on its valid zones and on the ng ghost zones that are not
+// covered by valid zones of this level, storing the burn in reactions.
+// With use_custom_knapsack_weights the burn weights are stored in weights.
 
-    // If we're using the custom knapsack weighting, copy state data
-    // to a new MultiFab with a corresponding distribution map.
+void
+Castro::strang_react(MultiFab& state, MultiFab& reactions, MultiFab* weights,
+		     Real time, Real dt, int ng)
+{
+
+    iMultiFab& interior_mask = build_interior_boundary_mask(ng);
+
+    // If we're burning on a different distribution map, copy the state
+    // data to a new MultiFab with that map.
 
     MultiFab* state_temp;
     MultiFab* reactions_temp;
     iMultiFab* mask_temp;
-    MultiFab* weights_temp;
+
+    // The burn weights are only kept for the custom knapsack weighting;
+    // otherwise react_state writes them to scratch space that is thrown away.
+
+    MultiFab* weights_temp = nullptr;
 
     // Use managed arrays so that we don't have to worry about
     // deleting things at the end.
@@ -57,23 +106,31 @@ Castro::strang_react_first_half(Real time, Real dt)
     Array<std::unique_ptr<MultiFab> > temp_data;
     std::unique_ptr<iMultiFab> temp_idata;
 
-    if (use_custom_knapsack_weights) {
+    // With react_lb_timed we may instead burn on a distribution map
+    // balanced by the measured burn cost. That map is only rebuilt when
+    // the predicted imbalance is large, so if nothing has changed the
+    // burn stays on the level's own map and we skip the copies entirely.
+
+    const bool timed_remap = react_lb_timed && update_reaction_dmap();
+    const bool use_knapsack = weights && !react_lb_timed;
+
+    if (timed_remap || use_knapsack) {
 
-	weights = &get_old_data(Knapsack_Weight_Type);
+	// Note that we want to use the "old" weights for the knapsack
+	// map; we've already done a swap on the new data for the old
+	// data, so this is really the burn from the last half-step.
 
-	// Note that we want to use the "old" data here; we've already
-	// done a swap on the new data for the old data, so this is
-	// really the new-time burn from the last timestep.
+	const DistributionMapping& dm = timed_remap ? react_dmap :
+	    DistributionMapping::makeKnapSack(get_old_data(Knapsack_Weight_Type));
 
-	const DistributionMapping& dm = DistributionMapping::makeKnapSack(get_old_data(Knapsack_Weight_Type));
-	
 	temp_data.push_back(std::unique_ptr<MultiFab>(
 				state_temp = new MultiFab(state.boxArray(), dm, state.nComp(), state.nGrow())));
 	temp_data.push_back(std::unique_ptr<MultiFab>(
 				reactions_temp = new MultiFab(reactions.boxArray(), dm, reactions.nComp(), reactions.nGrow())));
-	temp_data.push_back(std::unique_ptr<MultiFab>(
-				weights_temp = new MultiFab(weights->boxArray(), dm, weights->nComp(), weights->nGrow())));
-	temp_idata.reset(mask_temp = new iMultiFab(interior_mask.boxArray(), dm, interior_mask.nComp(), interior_mask.nGrow()));
+
+	if (use_knapsack)
+	    temp_data.push_back(std::unique_ptr<MultiFab>(
+				    weights_temp = new MultiFab(weights->boxArray(), dm, weights->nComp(), weights->nGrow())));
 
 	// Copy data from the state. Note that this is a parallel copy
 	// from FabArray, and the parallel copy assumes that the data
@@ -86,12 +143,34 @@ Castro::strang_react_first_half(Real time, Real dt)
 	// Create the mask. We cannot use the interior_mask from above, generated by
 	// Castro::build_interior_boundary_mask, because we need it to exist on the
 	// current DistributionMap and a parallel copy won't work for the mask.
+	// The mask on the timed map only depends on the map, so we keep it
+	// until the map changes.
 
 	int ghost_covered_by_valid = 0;
 	int other_cells = 1; // uncovered ghost, valid, and outside domain cells are set to 1
 
-	mask_temp->BuildMask(geom.Domain(), geom.periodicity(),
-		             ghost_covered_by_valid, other_cells, other_cells, other_cells);
+	if (timed_remap) {
+
+	    if (!react_mask || react_mask->nGrow() < ng) {
+
+		react_mask.reset(new iMultiFab(interior_mask.boxArray(), react_dmap, interior_mask.nComp(), ng));
+
+		react_mask->BuildMask(geom.Domain(), geom.periodicity(),
+				      ghost_covered_by_valid, other_cells, other_cells, other_cells);
+
+	    }
+
+	    mask_temp = react_mask.get();
+
+	}
+	else {
+
+	    temp_idata.reset(mask_temp = new iMultiFab(interior_mask.boxArray(), dm, interior_mask.nComp(), interior_mask.nGrow()));
+
+	    mask_temp->BuildMask(geom.Domain(), geom.periodicity(),
+				 ghost_covered_by_valid, other_cells, other_cells, other_cells);
+
+	}
 
     }
     else {
@@ -100,18 +179,12 @@ Castro::strang_react_first_half(Real time, Real dt)
 	reactions_temp = &reactions;
 	mask_temp = &interior_mask;
 
-	// Create a dummy weight array to pass to Fortran.
-
-	temp_data.push_back(std::unique_ptr<MultiFab>(
-				weights_temp = new MultiFab(reactions.boxArray(), reactions.DistributionMap(),
-							    reactions.nComp(), reactions.nGrow())));
-
     }
 
     if (verbose && ParallelDescriptor::IOProcessor())
         std::cout << "\n" << "... Entering burner and doing half-timestep of burning." << "\n";
 
-    react_state(*state_temp, *reactions_temp, *mask_temp, *weights_temp, time, dt, ng);
+    react_state(*state_temp, *reactions_temp, *mask_temp, weights_temp, time, dt, ng);
 
     if (verbose && ParallelDescriptor::IOProcessor())
         std::cout << "... Leaving burner after completing half-timestep of burning." << "\n";
@@ -125,14 +198,16 @@ Castro::strang_react_first_half(Real time, Real dt)
 
     // Copy data back to the state data if necessary.
 
-    if (use_custom_knapsack_weights) {
+    if (timed_remap || use_knapsack) {
 
 	state.copy(*state_temp, 0, 0, state_temp->nComp(), state_temp->nGrow(), state_temp->nGrow());
 	reactions.copy(*reactions_temp, 0, 0, reactions_temp->nComp(), reactions_temp->nGrow(), reactions_temp->nGrow());
-	weights->copy(*weights_temp, 0, 0, weights_temp->nComp(), weights_temp->nGrow(), weights_temp->nGrow());
 
     }
 
+    if (use_knapsack)
+	weights->copy(*weights_temp, 0, 0, weights_temp->nComp(), weights_temp->nGrow(), weights_temp->nGrow());
+
     // Ensure consistency in internal energy and recompute temperature.
 
     clean_state(state);
@@ -142,154 +217,354 @@ Castro::strang_react_first_half(Real time, Real dt)
 
 
 void
-Castro::strang_react_second_half(Real time, Real dt)
+Castro::react_state(MultiFab& s, MultiFab& r, const iMultiFab& mask, MultiFab* w, Real time, Real dt_react, int ngrow)
 {
 
-    MultiFab& reactions = get_new_data(Reactions_Type);
+    BL_PROFILE("Castro::react_state()");
 
-    reactions.setVal(0.0);
+    const Real strt_time = ParallelDescriptor::second();
 
-    if (do_react != 1) return;
+    // Initialize the weights to the default value (everything is weighted equally).
+    // If the caller doesn't want them, the burner writes them to scratch space.
 
-    MultiFab& state = get_new_data(State_Type);
+    if (w)
+	w->setVal(1.0);
 
-    // To be consistent with other source term types,
-    // we are only applying this on the interior zones.
+    // For react_lb_timed, the wall time spent burning each box, summed
+    // over the threads that worked on its tiles.
 
-    const int ng = 0;
+    Array<Real> box_time;
 
-    iMultiFab& interior_mask = build_interior_boundary_mask(ng);
+    if (react_lb_timed)
+	box_time.resize(s.boxArray().size(), 0.0);
 
-    MultiFab* weights;
+    if (react_dispatch == 1) {
 
-    // Most of the following uses the same logic as strang_react_first_half;
-    // look there for explanatory comments.
+	react_state_batched(s, r, mask, w, time, dt_react, ngrow, box_time);
 
-    MultiFab* state_temp;
-    MultiFab* reactions_temp;
-    iMultiFab* mask_temp;
-    MultiFab* weights_temp;
+    } else {
 
-    Array<std::unique_ptr<MultiFab> > temp_data;
-    std::unique_ptr<iMultiFab> temp_idata;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	{
+	    FArrayBox w_scratch;
 
-    if (use_custom_knapsack_weights) {
+	    for (MFIter mfi(s, true); mfi.isValid(); ++mfi)
+	    {
 
-	weights = &get_new_data(Knapsack_Weight_Type);
+		const Box& bx = mfi.growntilebox(ngrow);
 
-	// Here we use the old-time weights filled in during the first-half Strang-split burn.
+		if (!w)
+		    w_scratch.resize(bx, 1);
 
-	const DistributionMapping& dm = DistributionMapping::makeKnapSack(get_old_data(Knapsack_Weight_Type));
+		FArrayBox& wfab = w ? (*w)[mfi] : w_scratch;
 
-	temp_data.push_back(std::unique_ptr<MultiFab>(
-				state_temp = new MultiFab(state.boxArray(), dm, state.nComp(), state.nGrow())));
-	temp_data.push_back(std::unique_ptr<MultiFab>(
-				reactions_temp = new MultiFab(reactions.boxArray(), dm, reactions.nComp(), reactions.nGrow())));
-	temp_data.push_back(std::unique_ptr<MultiFab>(
-				weights_temp = new MultiFab(weights->boxArray(), dm, weights->nComp(), weights->nGrow())));
-	temp_idata.reset(mask_temp = new iMultiFab(interior_mask.boxArray(), dm, interior_mask.nComp(), interior_mask.nGrow()));
+		const Real tile_start = react_lb_timed ? ParallelDescriptor::second() : 0.0;
 
-	state_temp->copy(state, 0, 0, state.nComp(), state.nGrow(), state.nGrow());
+		// Note that box is *not* necessarily just the valid region!
+		ca_react_state(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+			       BL_TO_FORTRAN_3D(s[mfi]),
+			       BL_TO_FORTRAN_3D(r[mfi]),
+			       BL_TO_FORTRAN_3D(wfab),
+			       BL_TO_FORTRAN_3D(mask[mfi]),
+			       time, dt_react);
 
-	int ghost_covered_by_valid = 0;
-	int other_cells = 1;
+		if (react_lb_timed) {
+		    const Real tile_time = ParallelDescriptor::second() - tile_start;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+		    box_time[mfi.index()] += tile_time;
+		}
 
-	mask_temp->BuildMask(geom.Domain(), geom.periodicity(),
-		             ghost_covered_by_valid, other_cells, other_cells, other_cells);
+	    }
+	}
 
     }
-    else {
 
-	state_temp = &state;
-	reactions_temp = &reactions;
-	mask_temp = &interior_mask;
+    if (react_lb_timed)
+	update_reaction_cost(box_time);
 
-	temp_data.push_back(std::unique_ptr<MultiFab>(
-				weights_temp = new MultiFab(reactions.boxArray(), reactions.DistributionMap(),
-							    reactions.nComp(), reactions.nGrow())));
+    if (verbose) {
+
+	Real e_added = r.sum(NumSpec + 1);
+
+	if (ParallelDescriptor::IOProcessor() && e_added != 0.0)
+	    std::cout << "... (rho e) added from burning: " << e_added << std::endl;
 
     }
 
-    if (verbose && ParallelDescriptor::IOProcessor())
-        std::cout << "\n" << "... Entering burner and doing half-timestep of burning." << "\n";
+    if (verbose > 0)
+    {
+        const int IOProc   = ParallelDescriptor::IOProcessorNumber();
+        Real      run_time = ParallelDescriptor::second() - strt_time;
 
-    react_state(*state_temp, *reactions_temp, *mask_temp, *weights_temp, time, dt, ng);
+#ifdef BL_LAZY
+	Lazy::QueueReduction( [=] () mutable {
+#endif
+        ParallelDescriptor::ReduceRealMax(run_time,IOProc);
 
-    if (verbose && ParallelDescriptor::IOProcessor())
-        std::cout << "... Leaving burner after completing half-timestep of burning." << "\n";
+	if (ParallelDescriptor::IOProcessor())
+	  std::cout << "Castro::react_state() time = " << run_time << "\n" << "\n";
+#ifdef BL_LAZY
+	});
+#endif
+    }
 
-    state_temp->FillBoundary(geom.periodicity());
+}
 
-    if (use_custom_knapsack_weights) {
 
-	state.copy(*state_temp, 0, 0, state_temp->nComp(), state_temp->nGrow(), state_temp->nGrow());
-	reactions.copy(*reactions_temp, 0, 0, reactions_temp->nComp(), reactions_temp->nGrow(), reactions_temp->nGrow());
-	weights->copy(*weights_temp, 0, 0, weights_temp->nComp(), weights_temp->nGrow(), weights_temp->nGrow());
 
-    }
 
-    clean_state(state);
+namespace {
+
+    // A run of consecutive zones along the first dimension, all of
+    // which are to be burned, along with its estimated cost.
+
+    struct BurnRun
+    {
+	int  index;
+	Box  bx;
+	Real cost;
+    };
 
 }
 
 
 
+// Burn the zones of s selected by mask, but rather than giving each
+// thread whole tiles, flatten the zones to be burned into runs and hand
+// the runs out dynamically, most expensive first. Since the burn is
+// pointwise this gives the same result as the tile loop; it just keeps
+// a few very expensive zones (e.g. near a detonation front) from
+// stalling the other threads.
+
 void
-Castro::react_state(MultiFab& s, MultiFab& r, const iMultiFab& mask, MultiFab& w, Real time, Real dt_react, int ngrow)
+Castro::react_state_batched(MultiFab& s, MultiFab& r, const iMultiFab& mask, MultiFab* w,
+			    Real time, Real dt_react, int ngrow, Array<Real>& box_time)
 {
 
-    BL_PROFILE("Castro::react_state()");
+    BL_PROFILE("Castro::react_state_batched()");
 
-    const Real strt_time = ParallelDescriptor::second();
+    // The cost estimates are only meaningful for the layout they were
+    // measured on; start over if that changed.
 
-    // Initialize the weights to the default value (everything is weighted equally).
+    if (react_zone_cost.empty() || react_zone_cost.nGrow() < ngrow ||
+	!(react_zone_cost.DistributionMap() == s.DistributionMap())) {
 
-    w.setVal(1.0);
+	react_zone_cost.clear();
+	react_zone_cost.define(s.boxArray(), s.DistributionMap(), 1, ngrow);
+	react_zone_cost.setVal(0.0, ngrow);
 
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-    for (MFIter mfi(s, true); mfi.isValid(); ++mfi)
+    }
+
+    // Build the work list.
+
+    Array<BurnRun> runs;
+
+    for (MFIter mfi(s); mfi.isValid(); ++mfi)
     {
 
 	const Box& bx = mfi.growntilebox(ngrow);
 
-	// Note that box is *not* necessarily just the valid region!
-	ca_react_state(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-		       BL_TO_FORTRAN_3D(s[mfi]),
-		       BL_TO_FORTRAN_3D(r[mfi]),
-		       BL_TO_FORTRAN_3D(w[mfi]),
-		       BL_TO_FORTRAN_3D(mask[mfi]),
-		       time, dt_react);
+	const IArrayBox& m = mask[mfi];
+	const FArrayBox& c = react_zone_cost[mfi];
 
-    }
+	Box rows(bx);
+	rows.setBig(0, bx.smallEnd(0));
 
-    if (verbose) {
+	for (IntVect p = rows.smallEnd(); p <= rows.bigEnd(); rows.next(p))
+	{
+	    IntVect iv(p);
 
-	Real e_added = r.sum(NumSpec + 1);
+	    int start = bx.smallEnd(0);
+	    Real cost = 0.0;
 
-	if (ParallelDescriptor::IOProcessor() && e_added != 0.0)
-	    std::cout << "... (rho e) added from burning: " << e_added << std::endl;
+	    for (int i = bx.smallEnd(0); i <= bx.bigEnd(0) + 1; ++i)
+	    {
+		iv[0] = i;
+
+		if (i <= bx.bigEnd(0) && m(iv) == 1) {
+		    cost += c(iv);
+		    continue;
+		}
+
+		if (i > start) {
+		    Box run(bx);
+		    run.setSmall(0, start);
+		    run.setBig(0, i - 1);
+		    for (int d = 1; d < BL_SPACEDIM; ++d) {
+			run.setSmall(d, p[d]);
+			run.setBig(d, p[d]);
+		    }
+		    runs.push_back({mfi.index(), run, cost});
+		}
+
+		start = i + 1;
+		cost = 0.0;
+	    }
+	}
 
     }
 
-    if (verbose > 0)
+    std::stable_sort(runs.begin(), runs.end(),
+		     [] (const BurnRun& a, const BurnRun& b) { return a.cost > b.cost; });
+
+    const int nruns = runs.size();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-        const int IOProc   = ParallelDescriptor::IOProcessorNumber();
-        Real      run_time = ParallelDescriptor::second() - strt_time;
+	FArrayBox w_scratch;
 
-#ifdef BL_LAZY
-	Lazy::QueueReduction( [=] () mutable {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, react_dispatch_chunk)
 #endif
-        ParallelDescriptor::ReduceRealMax(run_time,IOProc);
+	for (int n = 0; n < nruns; ++n)
+	{
 
-	if (ParallelDescriptor::IOProcessor())
-	  std::cout << "Castro::react_state() time = " << run_time << "\n" << "\n";
-#ifdef BL_LAZY
-	});
+	    const BurnRun& run = runs[n];
+	    const Box& bx = run.bx;
+
+	    if (!w)
+		w_scratch.resize(bx, 1);
+
+	    FArrayBox& wfab = w ? (*w)[run.index] : w_scratch;
+
+	    const Real run_start = ParallelDescriptor::second();
+
+	    ca_react_state(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+			   BL_TO_FORTRAN_3D(s[run.index]),
+			   BL_TO_FORTRAN_3D(r[run.index]),
+			   BL_TO_FORTRAN_3D(wfab),
+			   BL_TO_FORTRAN_3D(mask[run.index]),
+			   time, dt_react);
+
+	    const Real run_time = ParallelDescriptor::second() - run_start;
+
+	    react_zone_cost[run.index].setVal(run_time / bx.numPts(), bx, 0, 1);
+
+	    if (react_lb_timed) {
+#ifdef _OPENMP
+#pragma omp atomic
 #endif
+		box_time[run.index] += run_time;
+	    }
+
+	}
     }
 
+    if (verbose > 1) {
+
+	long nzones = 0;
+	for (int n = 0; n < nruns; ++n)
+	    nzones += runs[n].bx.numPts();
+
+	long counts[2] = {static_cast<long>(nruns), nzones};
+
+	ParallelDescriptor::ReduceLongSum(counts, 2, ParallelDescriptor::IOProcessorNumber());
+
+	if (ParallelDescriptor::IOProcessor())
+	    std::cout << "... burned " << counts[1] << " zones in " << counts[0] << " runs" << std::endl;
+
+    }
+
+}
+
+
+
+// Fold the burn timings from the last react_state call into the smoothed
+// per-box cost. Every processor ends up with the cost of every box.
+
+void
+Castro::update_reaction_cost(Array<Real>& box_time)
+{
+
+    ParallelDescriptor::ReduceRealSum(box_time.dataPtr(), box_time.size());
+
+    if (react_cost.size() != box_time.size()) {
+	react_cost = box_time;
+	return;
+    }
+
+    for (int i = 0; i < react_cost.size(); ++i)
+	react_cost[i] = react_lb_smoothing * box_time[i] + (1.0 - react_lb_smoothing) * react_cost[i];
+
+}
+
+
+
+// The ratio of the maximum to the mean per-processor burn cost.
+
+static Real
+reaction_imbalance(const Array<Real>& cost, const DistributionMapping& dm)
+{
+
+    Array<Real> load(ParallelDescriptor::NProcs(), 0.0);
+
+    for (int i = 0; i < cost.size(); ++i)
+	load[dm[i]] += cost[i];
+
+    Real max_load = 0.0;
+    Real sum_load = 0.0;
+
+    for (int p = 0; p < load.size(); ++p) {
+	max_load = std::max(max_load, load[p]);
+	sum_load += load[p];
+    }
+
+    return sum_load > 0.0 ? max_load * load.size() / sum_load : 1.0;
+
+}
+
+
+
+// Decide which distribution map to burn on. If the map we are currently
+// using is predicted to be too imbalanced, try a knapsack map built from
+// the measured burn costs, and keep it if it is an improvement. Returns
+// true if the reactions should be done on react_dmap rather than on the
+// level's own map.
+
+bool
+Castro::update_reaction_dmap()
+{
+
+    // Without timings for every box there is nothing to balance on.
+
+    if (react_cost.size() != grids.size()) return react_remapped;
+
+    const Real imbalance = reaction_imbalance(react_cost, react_remapped ? react_dmap : dmap);
+
+    if (imbalance <= react_lb_threshold) return react_remapped;
+
+    // The knapsack uses the sum of the weights over each box, so spread
+    // the box cost evenly over its zones.
+
+    MultiFab cost(grids, dmap, 1, 0);
+
+    for (MFIter mfi(cost); mfi.isValid(); ++mfi)
+	cost[mfi].setVal(react_cost[mfi.index()] / grids[mfi.index()].numPts());
+
+    const DistributionMapping dm = DistributionMapping::makeKnapSack(cost);
+
+    const Real new_imbalance = reaction_imbalance(react_cost, dm);
+
+    if (new_imbalance < imbalance) {
+
+	react_remapped = !(dm == dmap);
+	react_dmap = dm;
+	react_mask.reset();
+
+	if (verbose && ParallelDescriptor::IOProcessor())
+	    std::cout << "... remapping reactions on level " << level << ": predicted burn imbalance "
+		      << imbalance << " -> " << new_imbalance << std::endl;
+
+    }
+
+    return react_remapped;
+
 }
 
 #else
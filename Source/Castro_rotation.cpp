@@ -54,12 +54,8 @@ void Castro::construct_old_rotation_source(Real time, Real dt)
 
 void Castro::construct_new_rotation_source(Real time, Real dt)
 {
-    MultiFab& S_old = get_old_data(State_Type);
     MultiFab& S_new = get_new_data(State_Type);
 
-    MultiFab& phirot_old = get_old_data(PhiRot_Type);
-    MultiFab& rot_old = get_old_data(Rotation_Type);
-
     MultiFab& phirot_new = get_new_data(PhiRot_Type);
     MultiFab& rot_new = get_new_data(Rotation_Type);
 
@@ -82,39 +78,64 @@ void Castro::construct_new_rotation_source(Real time, Real dt)
 
     // Now do corrector part of rotation source term update
 
-    const Real *dx = geom.CellSize();
-    const int* domlo = geom.Domain().loVect();
-    const int* domhi = geom.Domain().hiVect();
-
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
     {
+	FArrayBox dead_flux;
+
 	for (MFIter mfi(S_new,true); mfi.isValid(); ++mfi)
-	{
-	    const Box& bx = mfi.tilebox();
-
-	    ca_corrrsrc(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-			ARLIM_3D(domlo), ARLIM_3D(domhi),
-			BL_TO_FORTRAN_3D(phirot_old[mfi]),
-			BL_TO_FORTRAN_3D(phirot_new[mfi]),
-			BL_TO_FORTRAN_3D(rot_old[mfi]),
-			BL_TO_FORTRAN_3D(rot_new[mfi]),
-			BL_TO_FORTRAN_3D(S_old[mfi]),
-			BL_TO_FORTRAN_3D(S_new[mfi]),
-			BL_TO_FORTRAN_3D((*new_sources[rot_src])[mfi]),
-			BL_TO_FORTRAN_3D((*fluxes[0])[mfi]),
-			BL_TO_FORTRAN_3D((*fluxes[1])[mfi]),
-			BL_TO_FORTRAN_3D((*fluxes[2])[mfi]),
-			ZFILL(dx),dt,&time,
-			BL_TO_FORTRAN_3D(volume[mfi]));
-	}
+	    new_rotation_source_tile(mfi, (*new_sources[rot_src])[mfi], dead_flux, time, dt);
     }
 
 }
 
 
 
+// Corrector part of the rotation source on the tile of mfi. The new-time
+// rotation field must already have been filled with fill_rotation_field.
+// dead_flux is scratch space for the flux directions that don't exist.
+
+void Castro::new_rotation_source_tile(const MFIter& mfi, FArrayBox& src, FArrayBox& dead_flux,
+				      Real time, Real dt)
+{
+    MultiFab& S_old = get_old_data(State_Type);
+    MultiFab& S_new = get_new_data(State_Type);
+
+    MultiFab& phirot_old = get_old_data(PhiRot_Type);
+    MultiFab& rot_old = get_old_data(Rotation_Type);
+
+    MultiFab& phirot_new = get_new_data(PhiRot_Type);
+    MultiFab& rot_new = get_new_data(Rotation_Type);
+
+    const Real *dx = geom.CellSize();
+    const int* domlo = geom.Domain().loVect();
+    const int* domhi = geom.Domain().hiVect();
+
+    const Box& bx = mfi.tilebox();
+
+    FArrayBox& flux_x = fluxes.fab3d(0, mfi, dead_flux);
+    FArrayBox& flux_y = fluxes.fab3d(1, mfi, dead_flux);
+    FArrayBox& flux_z = fluxes.fab3d(2, mfi, dead_flux);
+
+    ca_corrrsrc(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+		ARLIM_3D(domlo), ARLIM_3D(domhi),
+		BL_TO_FORTRAN_3D(phirot_old[mfi]),
+		BL_TO_FORTRAN_3D(phirot_new[mfi]),
+		BL_TO_FORTRAN_3D(rot_old[mfi]),
+		BL_TO_FORTRAN_3D(rot_new[mfi]),
+		BL_TO_FORTRAN_3D(S_old[mfi]),
+		BL_TO_FORTRAN_3D(S_new[mfi]),
+		BL_TO_FORTRAN_3D(src),
+		BL_TO_FORTRAN_3D(flux_x),
+		BL_TO_FORTRAN_3D(flux_y),
+		BL_TO_FORTRAN_3D(flux_z),
+		ZFILL(dx),dt,&time,
+		BL_TO_FORTRAN_3D(volume[mfi]));
+}
+
+
+
 void Castro::fill_rotation_field(MultiFab& phi, MultiFab& rot, MultiFab& state, Real time)
 {
     const Real* dx = geom.CellSize();
@@ -11,7 +11,7 @@ void
 Castro::apply_source_to_state(MultiFab& state, MultiFab& source, Real dt)
 {
 
-  MultiFab::Saxpy(state, dt, source, 0, 0, NUM_STATE, 0);
+  MultiFab::Saxpy(state, dt, source, 0, 0, source.nComp(), 0);
 
 }
 
@@ -22,8 +22,10 @@ Castro::time_center_source_terms(MultiFab& S_new, MultiFab& src_old, MultiFab &s
 
   // Subtract off half of the old source term, and add half of the new.
 
-  MultiFab::Saxpy(S_new,-0.5*dt,src_old,0,0,S_new.nComp(),0);
-  MultiFab::Saxpy(S_new, 0.5*dt,src_new,0,0,S_new.nComp(),0);
+  BL_ASSERT(src_old.nComp() == src_new.nComp());
+
+  MultiFab::Saxpy(S_new,-0.5*dt,src_old,0,0,src_old.nComp(),0);
+  MultiFab::Saxpy(S_new, 0.5*dt,src_new,0,0,src_new.nComp(),0);
 }
 
 bool
@@ -77,10 +79,55 @@ Castro::source_flag(int src)
     } // end switch
 }
 
+int
+Castro::source_ncomp(int src)
+{
+    // Each source is stored over the leading components of the state,
+    // up to the last one it can change. A source that is switched off
+    // is all zero, so it only gets a single component.
+
+    if (!source_flag(src))
+	return 1;
+
+    switch(src) {
+
+    // The external source is problem-defined.
+
+    case ext_src:
+	return NUM_STATE;
+
+#ifdef DIFFUSION
+    case diff_src:
+	if (diffuse_spec == 1)
+	    return FirstSpec + NumSpec;
+	else
+	    return Eint + 1;
+#endif
+
+    // Sponge, hybrid, gravity and rotation update the momenta and the
+    // total energy, and their Fortran routines dimension the source
+    // through UEDEN.
+
+    default:
+	return Eden + 1;
+
+    } // end switch
+}
+
 void
 Castro::do_old_sources(Real time, Real dt, int amr_iteration, int amr_ncycle)
 {
 
+    // The old-time sources are evaluated on the ghost zones of
+    // Sborder, so any outstanding exchange must be finished first.
+
+    if (sborder_exchange_pending)
+	for (int n = 0; n < num_src; ++n)
+	    if (source_flag(n)) {
+		finish_state_exchange();
+		break;
+	    }
+
     // Construct the old-time sources.
 
     for (int n = 0; n < num_src; ++n)
@@ -132,6 +179,21 @@ Castro::do_new_sources(Real time, Real dt, int amr_iteration, int amr_ncycle)
 	    }
 	}
 
+    } else if (fuse_new_sources) {
+
+	Array< Array<Real> > summed_updates;
+
+	do_fused_new_sources(time, dt, amr_iteration, amr_ncycle, summed_updates);
+
+	clean_state(S_new);
+
+	if (print_update_diagnostics) {
+	    bool is_new = true;
+	    print_summed_source_changes(summed_updates, is_new);
+	}
+
+	return;
+
     } else {
 
 	// Construct the new-time source terms.
@@ -160,6 +222,174 @@ Castro::do_new_sources(Real time, Real dt, int amr_iteration, int amr_ncycle)
 
 }
 
+// Evaluate the new-time sources on S_new and add them to it, as the
+// unfused path does with update_state_between_sources = 0, but in a
+// single tiled sweep: the sponge, external, hybrid and rotation sources
+// only use the zone they update, so on each tile they are evaluated and
+// time-centered, and then all of the sources are added to S_new.
+// The other sources are constructed on their own beforehand. The
+// volume-weighted change due to each source is summed in the same sweep
+// for print_update_diagnostics.
+
+void
+Castro::do_fused_new_sources(Real time, Real dt, int amr_iteration, int amr_ncycle,
+                             Array< Array<Real> >& summed_updates)
+{
+    BL_PROFILE("Castro::do_fused_new_sources()");
+
+    MultiFab& S_old = get_old_data(State_Type);
+    MultiFab& S_new = get_new_data(State_Type);
+
+    Array<int> fused(num_src, 0);
+
+    for (int n = 0; n < num_src; ++n) {
+
+	if (source_flag(n)) {
+	    switch(n) {
+#ifdef SPONGE
+	    case sponge_src:
+#endif
+	    case ext_src:
+#ifdef HYBRID_MOMENTUM
+	    case hybrid_src:
+#endif
+#ifdef ROTATION
+	    case rot_src:
+#endif
+		fused[n] = 1;
+		break;
+	    default:
+		break;
+	    }
+	}
+
+	if (!fused[n])
+	    construct_new_source(n, time, dt, amr_iteration, amr_ncycle);
+
+    }
+
+    // Work that the fused sources need done on the whole level first.
+
+#ifdef SPONGE
+    if (fused[sponge_src])
+	update_sponge_params(&time);
+#endif
+
+#ifdef ROTATION
+    if (fused[rot_src])
+	fill_rotation_field(get_new_data(PhiRot_Type), get_new_data(Rotation_Type), S_new, time);
+#endif
+
+    const bool do_diagnostics = print_update_diagnostics;
+
+    summed_updates.resize(num_src);
+    for (int n = 0; n < num_src; ++n)
+	summed_updates[n].assign(NUM_STATE, 0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+	Array< Array<Real> > priv_updates(num_src);
+	for (int n = 0; n < num_src; ++n)
+	    priv_updates[n].assign(NUM_STATE, 0.0);
+
+	FArrayBox weighted;
+#ifdef ROTATION
+	FArrayBox dead_flux;
+#endif
+
+	for (MFIter mfi(S_new, true); mfi.isValid(); ++mfi)
+	{
+	    const Box& bx = mfi.tilebox();
+
+	    for (int n = 0; n < num_src; ++n) {
+
+		if (!fused[n]) continue;
+
+		FArrayBox& src = (*new_sources[n])[mfi];
+		const int ncomp = src.nComp();
+
+		src.setVal(0.0, mfi.growntilebox(new_sources[n]->nGrow()), 0, ncomp);
+
+		bool time_center = true;
+
+		switch(n) {
+
+#ifdef SPONGE
+		case sponge_src:
+		    sponge_source_tile(bx, S_new[mfi], src, volume[mfi], time, dt);
+		    time_center = time_center_sponge;
+		    break;
+#endif
+
+		case ext_src:
+		    ext_source_tile(bx, S_old[mfi], S_new[mfi], src, time, dt);
+		    break;
+
+#ifdef HYBRID_MOMENTUM
+		case hybrid_src:
+		    hybrid_source_tile(mfi.growntilebox(S_new.nGrow()), S_new[mfi], src);
+		    break;
+#endif
+
+#ifdef ROTATION
+		case rot_src:
+		    new_rotation_source_tile(mfi, src, dead_flux, time, dt);
+		    time_center = false;
+		    break;
+#endif
+
+		default:
+		    break;
+
+		}
+
+		// Time center the source term.
+
+		if (time_center) {
+		    src.mult(0.5, bx, 0, ncomp);
+		    src.saxpy(-0.5, (*old_sources[n])[mfi], bx, bx, 0, 0, ncomp);
+		}
+
+	    }
+
+	    // All of the sources have now been evaluated on this tile
+	    // with the same state, so they can be added to it.
+
+	    for (int n = 0; n < num_src; ++n) {
+
+		if (!source_flag(n)) continue;
+
+		const FArrayBox& src = (*new_sources[n])[mfi];
+		const int ncomp = src.nComp();
+
+		S_new[mfi].saxpy(dt, src, bx, bx, 0, 0, ncomp);
+
+		if (do_diagnostics) {
+		    weighted.resize(bx, 1);
+		    for (int c = 0; c < ncomp; ++c) {
+			weighted.copy(src, bx, c, bx, 0, 1);
+			weighted.mult(volume[mfi], bx, 0, 0, 1);
+			priv_updates[n][c] += weighted.sum(bx, 0) * dt;
+		    }
+		}
+
+	    }
+
+	}
+
+	if (do_diagnostics) {
+#ifdef _OPENMP
+#pragma omp critical (fused_source_updates)
+#endif
+	    for (int n = 0; n < num_src; ++n)
+		for (int c = 0; c < NUM_STATE; ++c)
+		    summed_updates[n][c] += priv_updates[n][c];
+	}
+    }
+}
+
 void
 Castro::construct_old_source(int src, Real time, Real dt, int amr_iteration, int amr_ncycle)
 {
@@ -266,7 +496,10 @@ Array<Real>
 Castro::evaluate_source_change(MultiFab& source, Real dt, bool local)
 {
 
-  Array<Real> update(source.nComp(), 0.0);
+  // The result is lined up with all NUM_STATE components of State_Type,
+  // even though the source may only store the leading ones.
+
+  Array<Real> update(NUM_STATE, 0.0);
 
   // Create a temporary array which will hold a single component
   // at a time of the volume-weighted source.
@@ -343,6 +576,17 @@ Castro::print_all_source_changes(Real dt, bool is_new)
 
   }
 
+  print_summed_source_changes(summed_updates, is_new);
+
+}
+
+// Reduce the (processor-local) changes due to each source, as
+// computed by evaluate_source_change, and print them.
+
+void
+Castro::print_summed_source_changes(Array< Array<Real> >& summed_updates, bool is_new)
+{
+
 #ifdef BL_LAZY
   Lazy::QueueReduction( [=] () mutable {
 #endif
@@ -410,12 +654,14 @@ Castro::sum_of_sources(MultiFab& source)
   source.setVal(0.0);
 
   for (int n = 0; n < num_src; ++n)
-      MultiFab::Add(source, *old_sources[n], 0, 0, NUM_STATE, ng);
+      if (source_flag(n))
+	  MultiFab::Add(source, *old_sources[n], 0, 0, old_sources[n]->nComp(), ng);
 
   MultiFab::Add(source, hydro_source, 0, 0, NUM_STATE, ng);
 
   for (int n = 0; n < num_src; ++n)
-      MultiFab::Add(source, *new_sources[n], 0, 0, NUM_STATE, ng);
+      if (source_flag(n))
+	  MultiFab::Add(source, *new_sources[n], 0, 0, new_sources[n]->nComp(), ng);
 
 }
 
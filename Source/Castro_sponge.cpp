@@ -15,8 +15,6 @@ Castro::construct_old_sponge_source(Real time, Real dt)
 
     update_sponge_params(&time);
 
-    const Real *dx = geom.CellSize();
-
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -24,12 +22,7 @@ Castro::construct_old_sponge_source(Real time, Real dt)
     {
 	const Box& bx = mfi.tilebox();
 
-	ca_sponge(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-		  BL_TO_FORTRAN_3D(Sborder[mfi]),
-		  BL_TO_FORTRAN_3D((*old_sources[sponge_src])[mfi]),
-		  BL_TO_FORTRAN_3D(volume[mfi]),
-		  ZFILL(dx), dt, &time);
-
+	sponge_source_tile(bx, Sborder[mfi], (*old_sources[sponge_src])[mfi], volume[mfi], time, dt);
     }
 
 }
@@ -47,8 +40,6 @@ Castro::construct_new_sponge_source(Real time, Real dt)
 
     update_sponge_params(&time);
 
-    const Real *dx = geom.CellSize();
-
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -56,12 +47,7 @@ Castro::construct_new_sponge_source(Real time, Real dt)
     {
 	const Box& bx = mfi.tilebox();
 
-	ca_sponge(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-		  BL_TO_FORTRAN_3D(S_new[mfi]),
-		  BL_TO_FORTRAN_3D((*new_sources[sponge_src])[mfi]),
-		  BL_TO_FORTRAN_3D(volume[mfi]),
-		  ZFILL(dx), dt, &time);
-
+	sponge_source_tile(bx, S_new[mfi], (*new_sources[sponge_src])[mfi], volume[mfi], time, dt);
     }
 
     // Time center the source term.
@@ -69,8 +55,26 @@ Castro::construct_new_sponge_source(Real time, Real dt)
     if (time_center_sponge) {
 	new_sources[sponge_src]->mult(0.5);
 
-	MultiFab::Saxpy(*new_sources[sponge_src],-0.5,*old_sources[sponge_src],0,0,NUM_STATE,ng);
+	MultiFab::Saxpy(*new_sources[sponge_src],-0.5,*old_sources[sponge_src],0,0,new_sources[sponge_src]->nComp(),ng);
     }
 
 }
+
+
+
+// Evaluate the sponge on a single tile. The sponge parameters must
+// already have been updated to this time with update_sponge_params.
+
+void
+Castro::sponge_source_tile(const Box& bx, FArrayBox& state, FArrayBox& src,
+                           FArrayBox& vol, Real time, Real dt)
+{
+    const Real *dx = geom.CellSize();
+
+    ca_sponge(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+	      BL_TO_FORTRAN_3D(state),
+	      BL_TO_FORTRAN_3D(src),
+	      BL_TO_FORTRAN_3D(vol),
+	      ZFILL(dx), dt, &time);
+}
 #endif
@@ -1,5 +1,6 @@
 #include <cmath>
 #include <limits>
+#include <algorithm>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -63,6 +64,8 @@ Gravity::Gravity(Amr* Parent, int _finest_level, BCRec* _phys_bc, int _Density)
     level_solver_resnorm(MAX_LEV),
     volume(MAX_LEV),
     area(MAX_LEV),
+    multipole_table(MAX_LEV),
+    radial_bin_cache(MAX_LEV),
     phys_bc(_phys_bc)
 {
      Density = _Density;
@@ -73,6 +76,8 @@ Gravity::Gravity(Amr* Parent, int _finest_level, BCRec* _phys_bc, int _Density)
      if (gravity_type == "PoissonGrav") init_multipole_grav();
 #endif
      max_rhs = 0.0;
+     for (int i = 0; i < 3; ++i)
+         multipole_table_center[i] = 0.0;
 }
 
 Gravity::~Gravity() {}
@@ -271,6 +276,10 @@ Gravity::install_level (int                   level,
 
     level_solver_resnorm[level] = 0.0;
 
+    multipole_table[level].reset();
+
+    invalidate_radial_bins(0);
+
     if (gravity_type == "PoissonGrav") {
 
        const DistributionMapping& dm = level_data->DistributionMap();
@@ -1430,6 +1439,8 @@ Gravity::make_radial_phi(int level, const MultiFab& Rhs, MultiFab& phi, int fill
     // Define total mass in each shell
     // Note that RHS = density (we have not yet multiplied by G)
 
+    const int add_mass = 1;
+
 #ifdef _OPENMP
     int nthreads = omp_get_max_threads();
     Array< Array<Real> > priv_radial_mass(nthreads);
@@ -1456,7 +1467,7 @@ Gravity::make_radial_phi(int level, const MultiFab& Rhs, MultiFab& phi, int fill
 				   radial_mass.dataPtr(),
 				   radial_vol.dataPtr(),
 #endif
-				   geom.ProbLo(),&n1d,&drdxfac,&level);
+				   geom.ProbLo(),&n1d,&drdxfac,&level,&add_mass);
 	}
 
 #ifdef _OPENMP
@@ -1587,23 +1598,42 @@ Gravity::fill_multipole_BCs(int crse_level, int fine_level, const Array<MultiFab
     const int boundary_only = 1;
 #endif
 
+    // If the center has moved, the cached geometric factors are stale.
+
+    Real center[3];
+    ca_get_center(center);
+
+    if (center[0] != multipole_table_center[0] ||
+        center[1] != multipole_table_center[1] ||
+        center[2] != multipole_table_center[2]) {
+
+        for (int lev = 0; lev < multipole_table.size(); ++lev)
+            multipole_table[lev].reset();
+
+        for (int i = 0; i < 3; ++i)
+            multipole_table_center[i] = center[i];
+
+    }
+
+    const int ncoef = (lnum + 1) * (lnum + 1);
+
     // Use all available data in constructing the boundary conditions,
     // unless the user has indicated that a maximum level at which
     // to stop using the more accurate data.
 
     for (int lev = crse_level; lev <= fine_level; ++lev) {
 
-	// Create a local copy of the RHS so that we can mask it.
+	// Zones covered by lev+1 are skipped by visiting only the
+	// uncovered parts of each tile.
 
-        MultiFab source(Rhs[lev - crse_level]->boxArray(), 
-			Rhs[lev - crse_level]->DistributionMap(), 1, 0);
+	const MultiFab& source = *Rhs[lev - crse_level];
 
-	MultiFab::Copy(source, *Rhs[lev - crse_level], 0, 0, 1, 0);
+	Castro* castro_level = dynamic_cast<Castro*>(LevelData[lev]);
 
-	if (lev < fine_level) {
-	    const MultiFab& mask = dynamic_cast<Castro*>(&(parent->getLevel(lev+1)))->build_fine_mask();
-	    MultiFab::Multiply(source, mask, 0, 0, 1, 0);
-	}
+	const bool masked = lev < fine_level;
+
+	if (masked)
+	    dynamic_cast<Castro*>(&(parent->getLevel(lev+1)))->build_fine_mask_boxes();
 
         // Loop through the grids and compute the individual contributions
         // to the various moments. The multipole moment constructor
@@ -1613,6 +1643,11 @@ Gravity::fill_multipole_BCs(int crse_level, int fine_level, const Array<MultiFab
         const Box& domain = parent->Geom(lev).Domain();
 	const Real* dx = parent->Geom(lev).CellSize();
 
+	// With the geometric factors cached, the moments are a plain
+	// contraction of the table with the source.
+
+	const MultiFab* table = (boundary_only == 1) ? build_multipole_table(lev) : nullptr;
+
 #ifdef _OPENMP
 	int nthreads = omp_get_max_threads();
 	Array<std::unique_ptr<FArrayBox> > priv_qL0(nthreads);
@@ -1640,27 +1675,51 @@ Gravity::fill_multipole_BCs(int crse_level, int fine_level, const Array<MultiFab
 	    priv_qU0[tid]->setVal(0.0);
 	    priv_qUC[tid]->setVal(0.0);
 	    priv_qUS[tid]->setVal(0.0);
+
+	    Real* tqL0 = priv_qL0[tid]->dataPtr();
+	    Real* tqLC = priv_qLC[tid]->dataPtr();
+	    Real* tqLS = priv_qLS[tid]->dataPtr();
+	    Real* tqU0 = priv_qU0[tid]->dataPtr();
+	    Real* tqUC = priv_qUC[tid]->dataPtr();
+	    Real* tqUS = priv_qUS[tid]->dataPtr();
+#else
+	    Real* tqL0 = qL0.dataPtr();
+	    Real* tqLC = qLC.dataPtr();
+	    Real* tqLS = qLS.dataPtr();
+	    Real* tqU0 = qU0.dataPtr();
+	    Real* tqUC = qUC.dataPtr();
+	    Real* tqUS = qUS.dataPtr();
 #endif
+	    std::vector<Box> boxes;
+
 	    for (MFIter mfi(source,true); mfi.isValid(); ++mfi)
 	    {
-	        const Box& bx = mfi.tilebox();
+		castro_level->fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), boxes, 0, masked);
 
-		ca_compute_multipole_moments(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
-		                             ARLIM_3D(domain.loVect()), ARLIM_3D(domain.hiVect()),
-					     ZFILL(dx),BL_TO_FORTRAN_3D(source[mfi]),
-					     BL_TO_FORTRAN_3D((*volume[lev])[mfi]),
-					     &lnum,
-#ifdef _OPENMP
-					     priv_qL0[tid]->dataPtr(),
-					     priv_qLC[tid]->dataPtr(),priv_qLS[tid]->dataPtr(),
-					     priv_qU0[tid]->dataPtr(),
-					     priv_qUC[tid]->dataPtr(),priv_qUS[tid]->dataPtr(),
-#else
-					     qL0.dataPtr(),qLC.dataPtr(),qLS.dataPtr(),
-					     qU0.dataPtr(),qUC.dataPtr(),qUS.dataPtr(),
-#endif
-					     &npts,&boundary_only);
-	}
+		for (int ib = 0; ib < boxes.size(); ++ib)
+		{
+		    const Box& bx = boxes[ib];
+
+		    if (table) {
+
+			ca_multipole_table_moments(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+						   BL_TO_FORTRAN_3D(source[mfi]),
+						   BL_TO_FORTRAN_3D((*table)[mfi]), &ncoef,
+						   &lnum, tqL0, tqLC, tqLS, &npts);
+
+		    } else {
+
+			ca_compute_multipole_moments(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+						     ARLIM_3D(domain.loVect()), ARLIM_3D(domain.hiVect()),
+						     ZFILL(dx),BL_TO_FORTRAN_3D(source[mfi]),
+						     BL_TO_FORTRAN_3D((*volume[lev])[mfi]),
+						     &lnum,
+						     tqL0, tqLC, tqLS, tqU0, tqUC, tqUS,
+						     &npts,&boundary_only);
+
+		    }
+		}
+	    }
 
 #ifdef _OPENMP
 	    int np0 = boxq0.numPts();
@@ -1727,16 +1786,37 @@ Gravity::fill_multipole_BCs(int crse_level, int fine_level, const Array<MultiFab
 
     } // end loop over levels
 
-    // Now, do a global reduce over all processes.
+    // Now, do a global reduce over all processes. All of the moments
+    // go into a single buffer so that this is one reduction.
 
-    ParallelDescriptor::ReduceRealSum(qL0.dataPtr(),boxq0.numPts());
-    ParallelDescriptor::ReduceRealSum(qLC.dataPtr(),boxqC.numPts());
-    ParallelDescriptor::ReduceRealSum(qLS.dataPtr(),boxqS.numPts());
+    std::vector<FArrayBox*> moments = {&qL0, &qLC, &qLS};
 
     if (boundary_only != 1) {
-      ParallelDescriptor::ReduceRealSum(qU0.dataPtr(),boxq0.numPts());
-      ParallelDescriptor::ReduceRealSum(qUC.dataPtr(),boxqC.numPts());
-      ParallelDescriptor::ReduceRealSum(qUS.dataPtr(),boxqS.numPts());
+      moments.push_back(&qU0);
+      moments.push_back(&qUC);
+      moments.push_back(&qUS);
+    }
+
+    long nmoments = 0;
+    for (int i = 0; i < moments.size(); ++i)
+      nmoments += moments[i]->box().numPts();
+
+    Array<Real> moment_buf(nmoments);
+
+    long offset = 0;
+    for (int i = 0; i < moments.size(); ++i) {
+      const long np = moments[i]->box().numPts();
+      std::copy(moments[i]->dataPtr(), moments[i]->dataPtr() + np, moment_buf.dataPtr() + offset);
+      offset += np;
+    }
+
+    ParallelDescriptor::ReduceRealSum(moment_buf.dataPtr(), nmoments);
+
+    offset = 0;
+    for (int i = 0; i < moments.size(); ++i) {
+      const long np = moments[i]->box().numPts();
+      std::copy(moment_buf.dataPtr() + offset, moment_buf.dataPtr() + offset + np, moments[i]->dataPtr());
+      offset += np;
     }
 
     // Finally, construct the boundary conditions using the
@@ -1777,6 +1857,253 @@ Gravity::fill_multipole_BCs(int crse_level, int fine_level, const Array<MultiFab
 #endif
     }
 
+}
+
+MultiFab*
+Gravity::build_multipole_table(int level)
+{
+    // The table holds (lnum+1)^2 factors per zone, so it can get large
+    // for high multipole orders; above the memory limit we go back to
+    // computing the factors in every zone.
+
+    const int ncoef = (lnum + 1) * (lnum + 1);
+
+    if (multipole_table[level] &&
+        multipole_table[level]->boxArray() == grids[level] &&
+        multipole_table[level]->DistributionMap() == dmap[level])
+        return multipole_table[level].get();
+
+    multipole_table[level].reset();
+
+    long local_zones = 0;
+    for (int i = 0; i < grids[level].size(); ++i)
+        if (dmap[level][i] == ParallelDescriptor::MyProc())
+            local_zones += grids[level][i].numPts();
+
+    const Real table_mb = static_cast<Real>(local_zones) * ncoef * sizeof(Real) / (1024.0 * 1024.0);
+
+    int fits = table_mb <= multipole_table_max_mb;
+    ParallelDescriptor::ReduceIntMin(fits);
+
+    if (!fits) return nullptr;
+
+    multipole_table[level].reset(new MultiFab(grids[level], dmap[level], ncoef, 0));
+
+    MultiFab& table = *multipole_table[level];
+
+    const Real* dx = parent->Geom(level).CellSize();
+
+#if (BL_SPACEDIM == 3)
+    const int npts = numpts_at_level;
+#else
+    const int npts = 1;
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(table, true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        ca_compute_multipole_table(ARLIM_3D(bx.loVect()), ARLIM_3D(bx.hiVect()),
+                                   ZFILL(dx), BL_TO_FORTRAN_3D((*volume[level])[mfi]),
+                                   &lnum, BL_TO_FORTRAN_3D(table[mfi]), &ncoef, &npts);
+    }
+
+    if (verbose > 1 && ParallelDescriptor::IOProcessor())
+        std::cout << "... built multipole table on level " << level
+                  << " (" << ncoef << " factors per zone)" << std::endl;
+
+    return multipole_table[level].get();
+}
+#endif
+
+#if (BL_SPACEDIM == 3)
+namespace {
+
+    // A Barnes-Hut octree over point masses, used to approximate the
+    // direct sum for the boundary potential (direct_sum_bcs = 2). Each
+    // node carries a monopole, dipole and quadrupole expansion about
+    // the center of its bounding box, so masses of either sign are fine.
+
+    struct TreeParticle
+    {
+        Real x[3];
+        Real m;
+    };
+
+    class BoundaryTree
+    {
+    public:
+
+        explicit BoundaryTree (std::vector<TreeParticle>& particles)
+            : p(particles)
+        {
+            if (!p.empty())
+                build(0, p.size(), 0);
+        }
+
+        // The potential -sum(m / r) at the point x (without the factor of G).
+
+        Real potential (const Real* x, Real theta) const
+        {
+            Real phi = 0.0;
+
+            if (nodes.empty()) return phi;
+
+            const Real theta2 = theta * theta;
+
+            int stack[8 * max_depth + 1];
+            int top = 0;
+            stack[top++] = 0;
+
+            while (top > 0)
+            {
+                const Node& n = nodes[stack[--top]];
+
+                const Real R[3] = {x[0] - n.c[0], x[1] - n.c[1], x[2] - n.c[2]};
+                const Real r2 = R[0] * R[0] + R[1] * R[1] + R[2] * R[2];
+
+                if (n.size2 < theta2 * r2)
+                {
+                    const Real rinv  = 1.0 / std::sqrt(r2);
+                    const Real rinv3 = rinv * rinv * rinv;
+                    const Real rinv5 = rinv3 * rinv * rinv;
+
+                    const Real dip = n.D[0] * R[0] + n.D[1] * R[1] + n.D[2] * R[2];
+                    const Real quad = n.Q[0] * R[0] * R[0] + n.Q[1] * R[1] * R[1] + n.Q[2] * R[2] * R[2] +
+                                      2.0 * (n.Q[3] * R[0] * R[1] + n.Q[4] * R[0] * R[2] + n.Q[5] * R[1] * R[2]);
+
+                    phi -= n.M * rinv + dip * rinv3 + 0.5 * quad * rinv5;
+                }
+                else if (n.leaf)
+                {
+                    for (long i = n.first; i < n.first + n.count; ++i)
+                    {
+                        const Real dx = x[0] - p[i].x[0];
+                        const Real dy = x[1] - p[i].x[1];
+                        const Real dz = x[2] - p[i].x[2];
+                        phi -= p[i].m / std::sqrt(dx * dx + dy * dy + dz * dz);
+                    }
+                }
+                else
+                {
+                    for (int c = 0; c < 8; ++c)
+                        if (n.child[c] >= 0)
+                            stack[top++] = n.child[c];
+                }
+            }
+
+            return phi;
+        }
+
+    private:
+
+        static const int leaf_size = 8;
+        static const int max_depth = 40;
+
+        struct Node
+        {
+            Real c[3];
+            Real size2;   // squared half-diagonal of the bounding box
+            Real M, D[3], Q[6];
+            long first, count;
+            int child[8];
+            bool leaf;
+        };
+
+        std::vector<TreeParticle>& p;
+        std::vector<Node> nodes;
+
+        int build (long first, long last, int depth)
+        {
+            const int id = nodes.size();
+            nodes.push_back(Node());
+
+            Real lo[3], hi[3];
+            for (int d = 0; d < 3; ++d) {
+                lo[d] = p[first].x[d];
+                hi[d] = p[first].x[d];
+            }
+            for (long i = first; i < last; ++i)
+                for (int d = 0; d < 3; ++d) {
+                    lo[d] = std::min(lo[d], p[i].x[d]);
+                    hi[d] = std::max(hi[d], p[i].x[d]);
+                }
+
+            Node n;
+            n.size2 = 0.0;
+            for (int d = 0; d < 3; ++d) {
+                n.c[d] = 0.5 * (lo[d] + hi[d]);
+                n.size2 += 0.25 * (hi[d] - lo[d]) * (hi[d] - lo[d]);
+            }
+
+            n.M = 0.0;
+            for (int d = 0; d < 3; ++d) n.D[d] = 0.0;
+            for (int d = 0; d < 6; ++d) n.Q[d] = 0.0;
+
+            for (long i = first; i < last; ++i)
+            {
+                const Real m = p[i].m;
+                const Real d[3] = {p[i].x[0] - n.c[0], p[i].x[1] - n.c[1], p[i].x[2] - n.c[2]};
+                const Real d2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+
+                n.M += m;
+                for (int k = 0; k < 3; ++k) {
+                    n.D[k] += m * d[k];
+                    n.Q[k] += m * (3.0 * d[k] * d[k] - d2);
+                }
+                n.Q[3] += 3.0 * m * d[0] * d[1];
+                n.Q[4] += 3.0 * m * d[0] * d[2];
+                n.Q[5] += 3.0 * m * d[1] * d[2];
+            }
+
+            n.first = first;
+            n.count = last - first;
+            for (int c = 0; c < 8; ++c) n.child[c] = -1;
+            n.leaf = (n.count <= leaf_size || depth >= max_depth || n.size2 == 0.0);
+
+            if (!n.leaf)
+            {
+                // Sort the particles into octants about the box center.
+
+                long bounds[9];
+                bounds[0] = first;
+                bounds[8] = last;
+
+                auto begin = p.begin();
+
+                const long mid_x = std::partition(begin + first, begin + last,
+                    [&] (const TreeParticle& a) { return a.x[0] < n.c[0]; }) - begin;
+
+                const long xr[3] = {first, mid_x, last};
+
+                for (int ix = 0; ix < 2; ++ix) {
+                    const long mid_y = std::partition(begin + xr[ix], begin + xr[ix+1],
+                        [&] (const TreeParticle& a) { return a.x[1] < n.c[1]; }) - begin;
+                    const long yr[3] = {xr[ix], mid_y, xr[ix+1]};
+                    for (int iy = 0; iy < 2; ++iy) {
+                        const long mid_z = std::partition(begin + yr[iy], begin + yr[iy+1],
+                            [&] (const TreeParticle& a) { return a.x[2] < n.c[2]; }) - begin;
+                        bounds[4*ix + 2*iy    ] = yr[iy];
+                        bounds[4*ix + 2*iy + 1] = mid_z;
+                    }
+                }
+
+                for (int c = 0; c < 8; ++c) {
+                    const long cend = (c < 7) ? bounds[c+1] : last;
+                    if (cend > bounds[c])
+                        n.child[c] = build(bounds[c], cend, depth + 1);
+                }
+            }
+
+            nodes[id] = n;
+
+            return id;
+        }
+    };
+
 }
 #endif
 
@@ -1802,7 +2129,7 @@ Gravity::fill_direct_sum_BCs(int crse_level, int fine_level, const Array<MultiFa
     const int hiVectXZ[3] = {domhi[0]+1, 0         , domhi[2]+1};
 
     const int loVectYZ[3] = {0         , domlo[1]-1, domlo[2]-1};
-    const int hiVectYZ[3] = {0         , domhi[1]+1, domhi[1]+1};
+    const int hiVectYZ[3] = {0         , domhi[1]+1, domhi[2]+1};
 
     const int bclo[3] = {domlo[0]-1, domlo[1]-1, domlo[2]-1};
     const int bchi[3] = {domhi[0]+1, domhi[1]+1, domhi[2]+1};
@@ -1838,6 +2165,31 @@ Gravity::fill_direct_sum_BCs(int crse_level, int fine_level, const Array<MultiFa
     bcYZLo.setVal(0.0);
     bcYZHi.setVal(0.0);
 
+    FArrayBox* bc[6] = {&bcXYLo, &bcXYHi, &bcXZLo, &bcXZHi, &bcYZLo, &bcYZHi};
+
+    // With direct_sum_bcs = 2 we approximate the sum with a tree over
+    // the local zones. If we are testing the tree, we also do the exact
+    // sum, into a separate set of arrays.
+
+    const bool use_tree = (direct_sum_bcs == 2);
+    const bool test_tree = use_tree && direct_sum_tree_test;
+    const bool do_direct = !use_tree || test_tree;
+
+    FArrayBox exact[6];
+    FArrayBox* dsum[6];
+
+    for (int f = 0; f < 6; ++f) {
+        if (test_tree) {
+            exact[f].resize(bc[f]->box(), 1);
+            exact[f].setVal(0.0);
+            dsum[f] = &exact[f];
+        } else {
+            dsum[f] = bc[f];
+        }
+    }
+
+    std::vector<TreeParticle> particles;
+
     // Loop through the grids and compute the individual contributions
     // to the BCs. The BC constructor is coded to only add to the
     // BCs, so it is safe to directly hand the arrays to them.
@@ -1855,21 +2207,84 @@ Gravity::fill_direct_sum_BCs(int crse_level, int fine_level, const Array<MultiFa
 
     for (int lev = crse_level; lev <= fine_level; ++lev) {
 
-	// Create a local copy of the RHS so that we can mask it.
+	// Zones covered by lev+1 are skipped by visiting only the
+	// uncovered parts of each grid.
 
-        MultiFab source(Rhs[lev - crse_level]->boxArray(),
-			Rhs[lev - crse_level]->DistributionMap(),
-			1, 0);
+	const MultiFab& source = *Rhs[lev - crse_level];
 
-	MultiFab::Copy(source, *Rhs[lev - crse_level], 0, 0, 1, 0);
+	Castro* castro_level = dynamic_cast<Castro*>(LevelData[lev]);
 
-	if (lev < fine_level) {
-	    const MultiFab& mask = dynamic_cast<Castro*>(&(parent->getLevel(lev+1)))->build_fine_mask();
-	    MultiFab::Multiply(source, mask, 0, 0, 1, 0);
-	}
+	const bool masked = lev < fine_level;
+
+	if (masked)
+	    dynamic_cast<Castro*>(&(parent->getLevel(lev+1)))->build_fine_mask_boxes();
 
 	const Real* dx = parent->Geom(lev).CellSize();
 
+	if (use_tree) {
+
+	    // Every zone with mass becomes a particle, along with its images
+	    // across any symmetry boundaries (all combinations of reflections
+	    // on the lo sides, and separately on the hi sides, as in the
+	    // direct sum).
+
+	    const Real* problo = crse_geom.ProbLo();
+	    const Real* probhi = crse_geom.ProbHi();
+
+	    std::vector<Box> boxes;
+
+	    for (MFIter mfi(source); mfi.isValid(); ++mfi)
+	    {
+		const FArrayBox& r = source[mfi];
+		const FArrayBox& v = (*volume[lev])[mfi];
+
+		castro_level->fine_mask_tile_boxes(mfi.index(), mfi.validbox(), boxes, 0, masked);
+
+		for (int ib = 0; ib < boxes.size(); ++ib)
+		{
+		    const Box& bx = boxes[ib];
+
+		    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+		    {
+			const Real m = r(iv) * v(iv);
+
+			if (m == 0.0) continue;
+
+			TreeParticle tp;
+			for (int d = 0; d < 3; ++d)
+			    tp.x[d] = problo[d] + (iv[d] + 0.5) * dx[d];
+			tp.m = m;
+
+			particles.push_back(tp);
+
+			for (int side = 0; side < 2; ++side)
+			{
+			    const int* side_bc = (side == 0) ? lo_bc : hi_bc;
+			    const Real* wall = (side == 0) ? problo : probhi;
+
+			    for (int refl = 1; refl < 8; ++refl)
+			    {
+				bool valid = true;
+				TreeParticle image = tp;
+
+				for (int d = 0; d < 3; ++d)
+				    if (refl & (1 << d)) {
+					if (side_bc[d] != symmetry_type) valid = false;
+					image.x[d] = 2.0 * wall[d] - tp.x[d];
+				    }
+
+				if (valid)
+				    particles.push_back(image);
+			    }
+			}
+		    }
+		}
+	    }
+
+	}
+
+	if (!do_direct) continue;
+
 #ifdef _OPENMP
 	int nthreads = omp_get_max_threads();
 	Array<std::unique_ptr<FArrayBox> > priv_bcXYLo(nthreads);
@@ -1898,40 +2313,47 @@ Gravity::fill_direct_sum_BCs(int crse_level, int fine_level, const Array<MultiFa
 	    priv_bcYZLo[tid]->setVal(0.0);
 	    priv_bcYZHi[tid]->setVal(0.0);
 #endif
+	    std::vector<Box> boxes;
+
 	    for (MFIter mfi(source,true); mfi.isValid(); ++mfi)
 	    {
-		const Box bx = mfi.tilebox();
-
 		const FArrayBox& r = source[mfi];
 		const FArrayBox& v = (*volume[lev])[mfi];
 
-		ca_compute_direct_sum_bc(bx.loVect(), bx.hiVect(), dx,
-					 &symmetry_type, lo_bc, hi_bc,
-					 r.dataPtr(), ARLIM_3D(r.loVect()), ARLIM_3D(r.hiVect()),
-					 v.dataPtr(), ARLIM_3D(v.loVect()), ARLIM_3D(v.hiVect()),
-					 crse_geom.ProbLo(),crse_geom.ProbHi(),
+		castro_level->fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), boxes, 0, masked);
+
+		for (int ib = 0; ib < boxes.size(); ++ib)
+		{
+		    const Box& bx = boxes[ib];
+
+		    ca_compute_direct_sum_bc(bx.loVect(), bx.hiVect(), dx,
+					     &symmetry_type, lo_bc, hi_bc,
+					     r.dataPtr(), ARLIM_3D(r.loVect()), ARLIM_3D(r.hiVect()),
+					     v.dataPtr(), ARLIM_3D(v.loVect()), ARLIM_3D(v.hiVect()),
+					     crse_geom.ProbLo(),crse_geom.ProbHi(),
 #ifdef _OPENMP
-					 priv_bcXYLo[tid]->dataPtr(),
-					 priv_bcXYHi[tid]->dataPtr(),
-					 priv_bcXZLo[tid]->dataPtr(),
-					 priv_bcXZHi[tid]->dataPtr(),
-					 priv_bcYZLo[tid]->dataPtr(),
-					 priv_bcYZHi[tid]->dataPtr(),
+					     priv_bcXYLo[tid]->dataPtr(),
+					     priv_bcXYHi[tid]->dataPtr(),
+					     priv_bcXZLo[tid]->dataPtr(),
+					     priv_bcXZHi[tid]->dataPtr(),
+					     priv_bcYZLo[tid]->dataPtr(),
+					     priv_bcYZHi[tid]->dataPtr(),
 #else
-					 bcXYLo.dataPtr(), bcXYHi.dataPtr(),
-					 bcXZLo.dataPtr(), bcXZHi.dataPtr(),
-					 bcYZLo.dataPtr(), bcYZHi.dataPtr(),
+					     dsum[0]->dataPtr(), dsum[1]->dataPtr(),
+					     dsum[2]->dataPtr(), dsum[3]->dataPtr(),
+					     dsum[4]->dataPtr(), dsum[5]->dataPtr(),
 #endif
-	                                 bclo, bchi, bcdx);
+					     bclo, bchi, bcdx);
+		}
 	    }
 
 #ifdef _OPENMP
-	    Real* pXYLo = bcXYLo.dataPtr();
-	    Real* pXYHi = bcXYHi.dataPtr();
-	    Real* pXZLo = bcXZLo.dataPtr();
-	    Real* pXZHi = bcXZHi.dataPtr();
-	    Real* pYZLo = bcYZLo.dataPtr();
-	    Real* pYZHi = bcYZHi.dataPtr();
+	    Real* pXYLo = dsum[0]->dataPtr();
+	    Real* pXYHi = dsum[1]->dataPtr();
+	    Real* pXZLo = dsum[2]->dataPtr();
+	    Real* pXZHi = dsum[3]->dataPtr();
+	    Real* pYZLo = dsum[4]->dataPtr();
+	    Real* pYZHi = dsum[5]->dataPtr();
 #pragma omp barrier
 #pragma omp for nowait
 	    for (int i=0; i<nPtsXY; i++) {
@@ -1965,6 +2387,66 @@ Gravity::fill_direct_sum_BCs(int crse_level, int fine_level, const Array<MultiFa
 
     } // end loop over levels
 
+    if (use_tree) {
+
+	const Real tree_strt = ParallelDescriptor::second();
+
+	BoundaryTree tree(particles);
+
+	// The boundary points, as in ca_compute_direct_sum_bc: phi lives
+	// on the domain faces, and the first and last points in each
+	// direction are the domain corners/edges.
+
+	const Real* problo = crse_geom.ProbLo();
+	const Real* probhi = crse_geom.ProbHi();
+
+	auto bc_loc = [&] (int d, int idx) -> Real {
+	    if (idx == bclo[d]) return problo[d];
+	    if (idx == bchi[d]) return probhi[d];
+	    return problo[d] + (idx + 0.5) * bcdx[d];
+	};
+
+	const Real Gconst = Ggravity / (4.0 * M_PI);
+
+	// The faces are ordered XY, XZ, YZ, so face f is normal to
+	// direction 2 - f / 2, on the lo side for even f.
+
+	for (int f = 0; f < 6; ++f)
+	{
+	    const int dir = 2 - f / 2;
+	    const Box& fbx = bc[f]->box();
+	    const long nfpts = fbx.numPts();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+	    for (long n = 0; n < nfpts; ++n)
+	    {
+		const IntVect iv = fbx.atOffset(n);
+
+		Real x[3];
+		for (int d = 0; d < 3; ++d)
+		    x[d] = (d == dir) ? ((f % 2 == 0) ? problo[d] : probhi[d]) : bc_loc(d, iv[d]);
+
+		(*bc[f])(iv) += Gconst * tree.potential(x, direct_sum_tree_theta);
+	    }
+	}
+
+	if (verbose)
+	{
+	    long np = particles.size();
+	    Real tree_time = ParallelDescriptor::second() - tree_strt;
+
+	    ParallelDescriptor::ReduceLongSum(np, ParallelDescriptor::IOProcessorNumber());
+	    ParallelDescriptor::ReduceRealMax(tree_time, ParallelDescriptor::IOProcessorNumber());
+
+	    if (ParallelDescriptor::IOProcessor())
+		std::cout << "... tree boundary potential from " << np << " masses, time = "
+			  << tree_time << std::endl;
+	}
+
+    }
+
     // because the number of elments in mpi_reduce is int
     BL_ASSERT(nPtsXY <= std::numeric_limits<int>::max());
     BL_ASSERT(nPtsXZ <= std::numeric_limits<int>::max());
@@ -1977,6 +2459,36 @@ Gravity::fill_direct_sum_BCs(int crse_level, int fine_level, const Array<MultiFa
     ParallelDescriptor::ReduceRealSum(bcYZLo.dataPtr(), nPtsYZ);
     ParallelDescriptor::ReduceRealSum(bcYZHi.dataPtr(), nPtsYZ);
 
+    if (test_tree) {
+
+	// Compare the tree evaluation with the exact direct sum.
+
+	Real max_err = 0.0;
+	Real max_phi = 0.0;
+
+	for (int f = 0; f < 6; ++f)
+	{
+	    ParallelDescriptor::ReduceRealSum(exact[f].dataPtr(), exact[f].box().numPts());
+
+	    FArrayBox err(bc[f]->box(), 1);
+	    err.copy(*bc[f]);
+	    err.minus(exact[f]);
+
+	    max_err = std::max(max_err, err.norm(0));
+	    max_phi = std::max(max_phi, exact[f].norm(0));
+	}
+
+	const Real rel_err = (max_phi > 0.0 ? max_err / max_phi : max_err);
+
+	if (ParallelDescriptor::IOProcessor())
+	    std::cout << "... tree boundary potential test: theta = " << direct_sum_tree_theta
+		      << ", max relative error = " << rel_err << std::endl;
+
+	if (direct_sum_tree_test_tol > 0.0 && rel_err > direct_sum_tree_test_tol)
+	    amrex::Abort("Gravity::fill_direct_sum_BCs: tree boundary potential does not match the direct sum");
+
+    }
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -2192,32 +2704,41 @@ Gravity::computeAvg (int level, MultiFab* mf, bool mask)
 
     BL_ASSERT(mf != 0);
 
+    Castro* castro_level = dynamic_cast<Castro*>(LevelData[level]);
+
     if (level < parent->finestLevel() && mask)
-    {
-	Castro* fine_level = dynamic_cast<Castro*>(&(parent->getLevel(level+1)));
-	const MultiFab& mask = fine_level->build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
+	dynamic_cast<Castro*>(&(parent->getLevel(level+1)))->build_fine_mask_boxes();
 
 #ifdef _OPENMP
 #pragma omp parallel reduction(+:sum)
 #endif
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
     {
-        FArrayBox& fab = (*mf)[mfi];
+        std::vector<Box> boxes;
+
+        for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
+        {
+            FArrayBox& fab = (*mf)[mfi];
 
-        Real s;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
+            // Zones covered by the finer level are skipped rather than zeroed.
 
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        //
-	ca_summass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
-		   dx,BL_TO_FORTRAN_3D((*volume[level])[mfi]),&s);
-        sum += s;
+            castro_level->fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), boxes, 0, mask);
+
+            for (int ib = 0; ib < boxes.size(); ++ib)
+            {
+                Real s;
+                const Box& box  = boxes[ib];
+                const int* lo   = box.loVect();
+                const int* hi   = box.hiVect();
+
+                //
+                // Note that this routine will do a volume weighted sum of
+                // whatever quantity is passed in, not strictly the "mass".
+                //
+		ca_summass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
+			   dx,BL_TO_FORTRAN_3D((*volume[level])[mfi]),&s);
+                sum += s;
+            }
+        }
     }
 
     ParallelDescriptor::ReduceRealSum(sum);
@@ -2226,6 +2747,126 @@ Gravity::computeAvg (int level, MultiFab* mf, bool mask)
 }
 #endif
 
+void
+Gravity::invalidate_radial_bins(int level)
+{
+    for (int lev = level; lev < MAX_LEV; ++lev)
+    {
+        radial_bin_cache[lev].valid[0] = false;
+        radial_bin_cache[lev].valid[1] = false;
+    }
+}
+
+void
+Gravity::bin_radial_mass(int lev, const MultiFab& state, int comp, bool finemask,
+                         Array<Real>& mass, Array<Real>& vol)
+{
+    BL_PROFILE("Gravity::bin_radial_mass()");
+
+    int n1d = mass.size();
+
+    for (int i = 0; i < n1d; i++) mass[i] = 0.;
+    for (int i = 0; i < n1d; i++) vol[i] = 0.;
+
+    const Geometry& geom = parent->Geom(lev);
+    const Real* dx   = geom.CellSize();
+    Real dr = dx[0] / double(drdxfac);
+
+    // With the fine mask, the mass is binned only from the zones not
+    // covered by lev+1. The covered zones still count toward the
+    // shell volumes, as they did when the state was multiplied by the
+    // mask, so only their volumes are binned.
+
+    Castro* castro_level = dynamic_cast<Castro*>(LevelData[lev]);
+
+    if (finemask)
+	dynamic_cast<Castro*>(&(parent->getLevel(lev+1)))->build_fine_mask_boxes();
+
+#ifdef _OPENMP
+    int nthreads = omp_get_max_threads();
+#else
+    int nthreads = 1;
+#endif
+    Array< Array<Real> > priv_radial_mass(nthreads);
+    Array< Array<Real> > priv_radial_vol (nthreads);
+    for (int i=0; i<nthreads; i++) {
+	priv_radial_mass[i].resize(n1d,0.0);
+	priv_radial_vol [i].resize(n1d,0.0);
+    }
+
+    const int add_mass = 1;
+    const int vol_only = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+	int tid = omp_get_thread_num();
+#else
+	int tid = 0;
+#endif
+	std::vector<Box> uncovered, covered;
+
+	for (MFIter mfi(state,true); mfi.isValid(); ++mfi)
+	{
+	    castro_level->fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), uncovered,
+					       finemask ? &covered : 0, finemask);
+
+	    for (int ib = 0; ib < uncovered.size(); ++ib)
+	    {
+		const Box& bx = uncovered[ib];
+
+		ca_compute_radial_mass(bx.loVect(), bx.hiVect(), dx, &dr,
+				       BL_TO_FORTRAN_N(state[mfi],comp),
+				       priv_radial_mass[tid].dataPtr(),
+				       priv_radial_vol[tid].dataPtr(),
+				       geom.ProbLo(),&n1d,&drdxfac,&lev,&add_mass);
+	    }
+
+	    if (finemask)
+	    {
+		for (int ib = 0; ib < covered.size(); ++ib)
+		{
+		    const Box& bx = covered[ib];
+
+		    ca_compute_radial_mass(bx.loVect(), bx.hiVect(), dx, &dr,
+					   BL_TO_FORTRAN_N(state[mfi],comp),
+					   priv_radial_mass[tid].dataPtr(),
+					   priv_radial_vol[tid].dataPtr(),
+					   geom.ProbLo(),&n1d,&drdxfac,&lev,&vol_only);
+		}
+	    }
+	}
+
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp for
+#endif
+	for (int i=0; i<n1d; i++) {
+	    for (int it=0; it<nthreads; it++) {
+		mass[i] += priv_radial_mass[it][i];
+		vol [i] += priv_radial_vol [it][i];
+	    }
+	}
+    }
+
+    // Pack both profiles into a single reduction.
+
+    Array<Real> buf(2*n1d);
+    for (int i = 0; i < n1d; i++) {
+	buf[i]     = mass[i];
+	buf[n1d+i] = vol[i];
+    }
+
+    ParallelDescriptor::ReduceRealSum(buf.dataPtr(), 2*n1d);
+
+    for (int i = 0; i < n1d; i++) {
+	mass[i] = buf[i];
+	vol[i]  = buf[n1d+i];
+    }
+}
+
 void
 Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
 {
@@ -2244,10 +2885,9 @@ Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
         const Real t_new = LevelData[lev]->get_state_data(State_Type).curTime();
         const Real eps   = (t_new - t_old) * 1.e-6;
 
-	const int NUM_STATE = LevelData[lev]->get_new_data(State_Type).nComp();
+        // Weights of the old and new time data at this time.
 
-        // Create MultiFab with NUM_STATE components and no ghost cells
-        MultiFab S(grids[lev],dmap[lev],NUM_STATE,0);
+        Real w_old, w_new;
 
 	if ( eps == 0.0 )
 	{
@@ -2255,29 +2895,23 @@ Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
             // dt is smaller than roundoff compared to the current time,
             // in which case we're probably in trouble anyway,
             // but we will still handle it gracefully here.
-            S.copy(LevelData[lev]->get_new_data(State_Type),0,0,NUM_STATE);
+            w_old = 0.0;
+            w_new = 1.0;
 	}
         else if ( std::abs(time-t_old) < eps)
         {
-            S.copy(LevelData[lev]->get_old_data(State_Type),0,0,NUM_STATE);
+            w_old = 1.0;
+            w_new = 0.0;
         }
         else if ( std::abs(time-t_new) < eps)
         {
-            S.copy(LevelData[lev]->get_new_data(State_Type),0,0,NUM_STATE);
+            w_old = 0.0;
+            w_new = 1.0;
         }
         else if (time > t_old && time < t_new)
         {
-            Real alpha   = (time - t_old)/(t_new - t_old);
-            Real omalpha = 1.0 - alpha;
-
-            S.copy(LevelData[lev]->get_old_data(State_Type),0,0,NUM_STATE);
-            S.mult(omalpha);
-
-            MultiFab S_new(grids[lev],dmap[lev],NUM_STATE,0);
-            S_new.copy(LevelData[lev]->get_new_data(State_Type),0,0,NUM_STATE);
-            S_new.mult(alpha);
-
-            S.plus(S_new,0,NUM_STATE,0);
+            w_new = (time - t_old)/(t_new - t_old);
+            w_old = 1.0 - w_new;
         }
         else
         {
@@ -2286,19 +2920,37 @@ Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
       	    amrex::Abort("Problem in Gravity::make_radial_gravity");
         }
 
-        if (lev < level)
-        {
-	    Castro* fine_level = dynamic_cast<Castro*>(&(parent->getLevel(lev+1)));
-	    const MultiFab& mask = fine_level->build_fine_mask();
-	    for (int n = 0; n < NUM_STATE; ++n)
-		MultiFab::Multiply(S, mask, 0, n, 1, 0);
-        }
+        const MultiFab& S_old = LevelData[lev]->get_old_data(State_Type);
+        const MultiFab& S_new = LevelData[lev]->get_new_data(State_Type);
 
         int n1d = radial_mass[lev].size();
 
 #ifdef GR_GRAV
+        // The pressure needs the full state through the EOS, so this
+        // path interpolates the whole state and bins it directly.
+
+	const int NUM_STATE = S_new.nComp();
+
+        MultiFab S(S_new.boxArray(),S_new.DistributionMap(),NUM_STATE,0);
+
+        if (w_old == 0.0)
+            MultiFab::Copy(S, S_new, 0, 0, NUM_STATE, 0);
+        else if (w_new == 0.0)
+            MultiFab::Copy(S, S_old, 0, 0, NUM_STATE, 0);
+        else
+            MultiFab::LinComb(S, w_old, S_old, 0, w_new, S_new, 0, 0, NUM_STATE, 0);
+
+        // Zones covered by lev+1 are skipped by visiting only the
+        // uncovered parts of each tile.
+
+        Castro* castro_level = dynamic_cast<Castro*>(LevelData[lev]);
+
+        const bool masked = lev < level;
+
+        if (masked)
+	    dynamic_cast<Castro*>(&(parent->getLevel(lev+1)))->build_fine_mask_boxes();
+
         for (int i = 0; i < n1d; i++) radial_pres[lev][i] = 0.;
-#endif
         for (int i = 0; i < n1d; i++) radial_vol[lev][i] = 0.;
         for (int i = 0; i < n1d; i++) radial_mass[lev][i] = 0.;
 
@@ -2308,17 +2960,9 @@ Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
 
 #ifdef _OPENMP
 	int nthreads = omp_get_max_threads();
-#ifdef GR_GRAV
 	Array< Array<Real> > priv_radial_pres(nthreads);
-#endif
-	Array< Array<Real> > priv_radial_mass(nthreads);
-	Array< Array<Real> > priv_radial_vol (nthreads);
 	for (int i=0; i<nthreads; i++) {
-#ifdef GR_GRAV
 	    priv_radial_pres[i].resize(n1d,0.0);
-#endif
-	    priv_radial_mass[i].resize(n1d,0.0);
-	    priv_radial_vol [i].resize(n1d,0.0);
 	}
 #pragma omp parallel
 #endif
@@ -2326,32 +2970,27 @@ Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
 #ifdef _OPENMP
 	    int tid = omp_get_thread_num();
 #endif
+	    std::vector<Box> boxes;
+
 	    for (MFIter mfi(S,true); mfi.isValid(); ++mfi)
 	    {
-	        const Box& bx = mfi.tilebox();
 		FArrayBox& fab = S[mfi];
 
-		ca_compute_radial_mass(bx.loVect(), bx.hiVect(), dx, &dr,
+		castro_level->fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), boxes, 0, masked);
+
+		for (int ib = 0; ib < boxes.size(); ++ib)
+		{
+		    const Box& bx = boxes[ib];
+
+		    ca_compute_avgpres(bx.loVect(), bx.hiVect(), dx, &dr,
 				       BL_TO_FORTRAN(fab),
 #ifdef _OPENMP
-				       priv_radial_mass[tid].dataPtr(),
-				       priv_radial_vol[tid].dataPtr(),
+				       priv_radial_pres[tid].dataPtr(),
 #else
-				       radial_mass[lev].dataPtr(),
-				       radial_vol[lev].dataPtr(),
+				       radial_pres[lev].dataPtr(),
 #endif
 				       geom.ProbLo(),&n1d,&drdxfac,&lev);
-
-#ifdef GR_GRAV
-		ca_compute_avgpres(bx.loVect(), bx.hiVect(), dx, &dr,
-				   BL_TO_FORTRAN(fab),
-#ifdef _OPENMP
-				   priv_radial_pres[tid].dataPtr(),
-#else
-				   radial_pres[lev].dataPtr(),
-#endif
-				   geom.ProbLo(),&n1d,&drdxfac,&lev);
-#endif
+		}
 	    }
 
 #ifdef _OPENMP
@@ -2359,20 +2998,65 @@ Gravity::make_radial_gravity(int level, Real time, Array<Real>& radial_grav)
 #pragma omp for
 	    for (int i=0; i<n1d; i++) {
 		for (int it=0; it<nthreads; it++) {
-#ifdef GR_GRAV
 	            radial_pres[lev][i] += priv_radial_pres[it][i];
-#endif
-	            radial_mass[lev][i] += priv_radial_mass[it][i];
-		    radial_vol [lev][i] += priv_radial_vol [it][i];
 		}
 	    }
 #endif
 	}
 
-        ParallelDescriptor::ReduceRealSum(radial_mass[lev].dataPtr() ,n1d);
-        ParallelDescriptor::ReduceRealSum(radial_vol[lev].dataPtr()  ,n1d);
-#ifdef GR_GRAV
         ParallelDescriptor::ReduceRealSum(radial_pres[lev].dataPtr()  ,n1d);
+
+        bin_radial_mass(lev, S, Density, masked, radial_mass[lev], radial_vol[lev]);
+#else
+        if (lev < level)
+        {
+            // The binning is linear in the density and the bin volumes do
+            // not depend on it, so the masked coarse bins are computed once
+            // per old/new state and combined with the time weights here.
+            // Subcycled fine levels then reuse them without re-binning.
+
+            RadialBinCache& cache = radial_bin_cache[lev];
+
+            const Real   t_slot[2] = { t_old, t_new };
+            const Real   w_slot[2] = { w_old, w_new };
+            const MultiFab* S_slot[2] = { &S_old, &S_new };
+
+            for (int n = 0; n < 2; ++n)
+            {
+                if (w_slot[n] == 0.0) continue;
+
+                if (cache.valid[n] && cache.time[n] == t_slot[n]) continue;
+
+                cache.mass[n].resize(n1d);
+                cache.vol.resize(n1d);
+
+                bin_radial_mass(lev, *S_slot[n], Density, true, cache.mass[n], cache.vol);
+
+                cache.time[n]  = t_slot[n];
+                cache.valid[n] = true;
+            }
+
+            for (int i = 0; i < n1d; i++)
+            {
+                radial_mass[lev][i] = 0.;
+                if (w_old != 0.0) radial_mass[lev][i] += w_old * cache.mass[0][i];
+                if (w_new != 0.0) radial_mass[lev][i] += w_new * cache.mass[1][i];
+                radial_vol[lev][i] = cache.vol[i];
+            }
+        }
+        else
+        {
+            MultiFab rho(S_new.boxArray(),S_new.DistributionMap(),1,0);
+
+            if (w_old == 0.0)
+                MultiFab::Copy(rho, S_new, Density, 0, 1, 0);
+            else if (w_new == 0.0)
+                MultiFab::Copy(rho, S_old, Density, 0, 1, 0);
+            else
+                MultiFab::LinComb(rho, w_old, S_old, Density, w_new, S_new, Density, 0, 1, 0);
+
+            bin_radial_mass(lev, rho, 0, false, radial_mass[lev], radial_vol[lev]);
+        }
 #endif
 
         if (do_diag > 0)
@@ -234,6 +234,58 @@ void Radiation::compute_coupling(MultiFab& coupT, MultiFab& coupY,
 }
 
 
+// same_op[g] is set to 1 if group g sees exactly the same linear operator
+// as group g-1, i.e., the Planck and Rosseland opacities (and the flux
+// limiter, if one is used) agree component by component.  The boundary
+// values only enter through the right hand side, so they do not matter.
+
+void Radiation::find_shared_operators(Array<int>& same_op,
+				      const MultiFab& kappa_p, const MultiFab& kappa_r,
+				      const Tuple<MultiFab, BL_SPACEDIM>& lambda,
+				      int limiter)
+{
+    BL_PROFILE("Radiation::find_shared_operators");
+
+    same_op.resize(nGroups);
+    for (int igroup = 0; igroup < nGroups; igroup++) {
+	same_op[igroup] = (igroup > 0) ? 1 : 0;
+    }
+
+    if (nGroups < 2) return;
+
+    for (MFIter mfi(kappa_p); mfi.isValid(); ++mfi) {
+	const Box& bx = mfi.validbox();
+	const Box& kbx = kappa_r[mfi].box();
+	const FArrayBox& kp = kappa_p[mfi];
+	const FArrayBox& kr = kappa_r[mfi];
+
+	for (int igroup = 1; igroup < nGroups; igroup++) {
+	    if (same_op[igroup] == 0) continue;
+
+	    bool same = true;
+	    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd() && same; bx.next(iv)) {
+		same = (kp(iv,igroup) == kp(iv,igroup-1));
+	    }
+	    for (IntVect iv = kbx.smallEnd(); iv <= kbx.bigEnd() && same; kbx.next(iv)) {
+		same = (kr(iv,igroup) == kr(iv,igroup-1));
+	    }
+	    if (limiter > 0) {
+		for (int idim = 0; idim < BL_SPACEDIM && same; idim++) {
+		    const FArrayBox& lam = lambda[idim][mfi];
+		    const Box& lbx = amrex::surroundingNodes(bx,idim);
+		    for (IntVect iv = lbx.smallEnd(); iv <= lbx.bigEnd() && same; lbx.next(iv)) {
+			same = (lam(iv,igroup) == lam(iv,igroup-1));
+		    }
+		}
+	    }
+
+	    if (!same) same_op[igroup] = 0;
+	}
+    }
+
+    ParallelDescriptor::ReduceIntMin(same_op.dataPtr(), nGroups);
+}
+
 void Radiation::compute_eta_theta(MultiFab& etaT, MultiFab& etaTz, 
 				  MultiFab& etaY, MultiFab& etaYz, 
 				  MultiFab& eta1,
@@ -18,6 +18,140 @@
 
 using namespace amrex;
 
+Radiation::MGFLDWorkspace& Radiation::get_mgfld_workspace(int level)
+{
+  if (mgfld_work[level]) {
+    return *mgfld_work[level];
+  }
+
+  BL_PROFILE("Radiation::get_mgfld_workspace");
+
+  Castro *castro = dynamic_cast<Castro*>(&parent->getLevel(level));
+  const BoxArray& grids = castro->boxArray();
+  const DistributionMapping& dmap = castro->DistributionMap();
+
+  mgfld_work[level].reset(new MGFLDWorkspace);
+  MGFLDWorkspace& w = *mgfld_work[level];
+
+  w.Er_old.define(grids, dmap, castro->get_new_data(Rad_Type).nComp(), 0);
+  w.Er_pi.define(grids, dmap, nGroups, 1);
+  w.Er_star.define(grids, dmap, nGroups, 1);
+  w.rhs.define(grids, dmap, 1, 0);
+
+  w.rhoe_new.define(grids, dmap, 1, 0);
+  w.rhoe_old.define(grids, dmap, 1, 0);
+  w.rhoe_star.define(grids, dmap, 1, 0);
+
+  w.rho.define(grids, dmap, 1, 1);
+  w.temp_new.define(grids, dmap, 1, 1);
+  w.temp_star.define(grids, dmap, 1, 0);
+
+  w.kappa_p.define(grids, dmap, nGroups, 1);
+  w.kappa_r.define(grids, dmap, nGroups, 1);
+  w.jg.define(grids, dmap, nGroups, 1);
+  w.djdT.define(grids, dmap, nGroups, 1);
+  w.dkdT.define(grids, dmap, nGroups, 1);
+  w.dedT.define(grids, dmap, 1, 0);
+  w.etaT.define(grids, dmap, 1, 0);
+  w.etaTz.define(grids, dmap, 1, 0);
+  w.eta1.define(grids, dmap, 1, 0);
+  w.coupT.define(grids, dmap, 1, 0);
+
+#ifdef NEUTRINO
+  w.rhoYe_new.define(grids, dmap, 1, 0);
+  w.rhoYe_old.define(grids, dmap, 1, 0);
+  w.rhoYe_star.define(grids, dmap, 1, 0);
+  w.Ye_new.define(grids, dmap, 1, 1);
+  w.Ye_star.define(grids, dmap, 1, 0);
+
+  w.djdY.define(grids, dmap, nGroups, 1);
+  w.dkdY.define(grids, dmap, nGroups, 1);
+  w.dedY.define(grids, dmap, 1, 0);
+  w.etaY.define(grids, dmap, 1, 0);
+  w.etaYz.define(grids, dmap, 1, 0);
+  w.thetaT.define(grids, dmap, 1, 0);
+  w.thetaY.define(grids, dmap, 1, 0);
+  w.thetaTz.define(grids, dmap, 1, 0);
+  w.thetaYz.define(grids, dmap, 1, 0);
+  w.theta1.define(grids, dmap, 1, 0);
+  w.coupY.define(grids, dmap, 1, 0);
+#else
+  if (castro->NumAux > 0) {
+    w.Ye_new.define(grids, dmap, 1, 1);
+  }
+#endif
+
+  for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+    if (limiter > 0) {
+      w.lambda[idim].define(castro->getEdgeBoxArray(idim), dmap, nGroups, 0);
+    }
+    else {
+      w.lambda[idim].define(castro->getEdgeBoxArray(idim), dmap, 1, 0);
+      w.lambda[idim].setVal(1./3.);
+    }
+    w.Flux[idim].define(castro->getEdgeBoxArray(idim), dmap, 1, 0);
+  }
+
+  if (limiter > 0 && inner_update_limiter == -1) {
+    w.kpr_lag.define(grids, dmap, nGroups, 1);
+  }
+
+  if (!plot_com_flux && (plot_lab_Er || plot_lab_flux)) {
+    w.flxsave.define(grids, dmap, nGroups*BL_SPACEDIM, 0);
+  }
+
+  w.mgbd.reset(new MGRadBndry(grids, dmap, nGroups, castro->Geom()));
+
+  w.solver.reset(new RadSolve(parent));
+  w.solver->levelInit(level);
+
+  const MultiFab* mfs[] = { &w.Er_old, &w.Er_pi, &w.Er_star, &w.rhs,
+			    &w.rhoe_new, &w.rhoe_old, &w.rhoe_star,
+			    &w.rhoYe_new, &w.rhoYe_old, &w.rhoYe_star,
+			    &w.rho, &w.temp_new, &w.temp_star, &w.Ye_new, &w.Ye_star,
+			    &w.kappa_p, &w.kappa_r, &w.kpr_lag, &w.jg,
+			    &w.djdT, &w.dkdT, &w.djdY, &w.dkdY, &w.dedT, &w.dedY,
+			    &w.etaT, &w.etaTz, &w.eta1, &w.etaY, &w.etaYz,
+			    &w.thetaT, &w.thetaY, &w.thetaTz, &w.thetaYz, &w.theta1,
+			    &w.coupT, &w.coupY, &w.flxsave,
+			    D_DECL(&w.lambda[0], &w.lambda[1], &w.lambda[2]),
+			    D_DECL(&w.Flux[0], &w.Flux[1], &w.Flux[2]) };
+
+  w.nbytes = 0;
+  for (const MultiFab* mf : mfs) {
+    if (mf->ok()) {
+      for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+	w.nbytes += (*mf)[mfi].nBytes();
+      }
+    }
+  }
+
+  long total = 0;
+  for (int lev = 0; lev < mgfld_work.size(); lev++) {
+    if (mgfld_work[lev]) {
+      total += mgfld_work[lev]->nbytes;
+    }
+  }
+  mgfld_work_peak = (total > mgfld_work_peak) ? total : mgfld_work_peak;
+
+  if (verbose > 0) {
+    long level_bytes = w.nbytes;
+    long peak = mgfld_work_peak;
+    ParallelDescriptor::ReduceLongMax(level_bytes);
+    ParallelDescriptor::ReduceLongMax(total);
+    ParallelDescriptor::ReduceLongMax(peak);
+    if (ParallelDescriptor::IOProcessor()) {
+      const Real mb = 1024.0*1024.0;
+      std::cout << "MGFLD workspace built at level " << level
+		<< ": " << level_bytes/mb << " MB, all levels: "
+		<< total/mb << " MB (peak " << peak/mb
+		<< " MB), max per rank" << std::endl;
+    }
+  }
+
+  return w;
+}
+
 void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 { 
   BL_PROFILE("Radiation::MGFLD_implicit_update");
@@ -46,12 +180,10 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   MultiFab& S_new = castro->get_new_data(State_Type);
   AmrLevel::FillPatch(*castro,S_new,ngrow,time,State_Type,0,S_new.nComp(),0); 
 
-  Tuple<MultiFab, BL_SPACEDIM> lambda;
-  if (limiter > 0) {
-    for (int idim = 0; idim < BL_SPACEDIM; idim++) {
-	lambda[idim].define(castro->getEdgeBoxArray(idim), dmap, nGroups, 0);
-    }
+  MGFLDWorkspace& work = get_mgfld_workspace(level);
 
+  Tuple<MultiFab, BL_SPACEDIM>& lambda = work.lambda;
+  if (limiter > 0) {
     if (inner_update_limiter == -1) {
       MultiFab& Er_lag = castro->get_old_data(Rad_Type);
       Er_lag.setBndry(-1.0);
@@ -63,23 +195,13 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 	S_lag[fpi].copy(fpi());
       }
 
-      MultiFab kpr_lag(grids,dmap,nGroups,1);
+      MultiFab& kpr_lag = work.kpr_lag;
       MGFLD_compute_rosseland(kpr_lag, S_lag); 
 
-      for (int igroup=0; igroup<nGroups; ++igroup) {
-	scaledGradient(level, lambda, kpr_lag, igroup, Er_lag, igroup, limiter, 1, igroup);
-	// lambda now contains scaled gradient
-	fluxLimiter(level, lambda, limiter, igroup);
-	// lambda now contains flux limiter
-      }
+      groupFluxLimiter(level, lambda, kpr_lag, Er_lag, limiter);
+      // lambda now contains flux limiter
     }
   }
-  else {
-    for (int idim = 0; idim < BL_SPACEDIM; idim++) {
-	lambda[idim].define(castro->getEdgeBoxArray(idim), dmap, 1, 0);
-      lambda[idim].setVal(1./3.);
-    }    
-  }
 
   // Er_new: work copy
   // Er_old: the input state of the implicit update
@@ -88,7 +210,7 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   //
   MultiFab& Er_new = castro->get_new_data(Rad_Type);
   {
-    MultiFab rhs(grids,dmap,1,0);
+    MultiFab& rhs = work.rhs;
     for (int igroup=0; igroup<nGroups; igroup++) {
       rhs.setVal(0.0);
       deferred_sync(level, rhs, igroup);
@@ -96,37 +218,26 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
       MultiFab::Add(Er_new, rhs, 0, igroup, 1, 0);
     }
   }
-  MultiFab Er_old(grids, dmap , Er_new.nComp(), 0);
+  MultiFab& Er_old = work.Er_old;
   Er_old.copy(Er_new); 
-  MultiFab Er_pi(grids,dmap,nGroups,1);
-  MultiFab Er_star(grids, dmap, nGroups, 1);
+  MultiFab& Er_pi = work.Er_pi;
+  MultiFab& Er_star = work.Er_star;
   Er_pi.setBndry(-1.0); // later we may use it to compute limiter
   Er_star.setBndry(-1.0); // later we may use it to compute limiter
 
-  MultiFab rhoe_new(grids,dmap,1,0);
-  MultiFab rhoe_old(grids,dmap,1,0);
-  MultiFab rhoe_star(grids,dmap,1,0);
+  MultiFab& rhoe_new = work.rhoe_new;
+  MultiFab& rhoe_old = work.rhoe_old;
+  MultiFab& rhoe_star = work.rhoe_star;
 
-#ifdef NEUTRINO
-  MultiFab rhoYe_new(grids,dmap, 1, 0);
-  MultiFab rhoYe_old(grids,dmap, 1, 0);
-  MultiFab rhoYe_star(grids,dmap, 1, 0);
-#else
-  MultiFab rhoYe_new, rhoYe_old, rhoYe_star;
-#endif
+  MultiFab& rhoYe_new = work.rhoYe_new;
+  MultiFab& rhoYe_old = work.rhoYe_old;
+  MultiFab& rhoYe_star = work.rhoYe_star;
 
-  MultiFab rho(grids,dmap,1,1);
-  MultiFab temp_new(grids,dmap,1,1); // ghost cell for kappa_r
-  MultiFab temp_star(grids,dmap,1,0);
-#ifdef NEUTRINO
-  MultiFab Ye_new(grids,dmap, 1, 1);
-  MultiFab Ye_star(grids,dmap, 1, 0);
-#else
-  MultiFab Ye_new, Ye_star;
-  if (castro->NumAux > 0) {
-      Ye_new.define(grids, dmap, 1, 1);
-  }
-#endif
+  MultiFab& rho = work.rho;
+  MultiFab& temp_new = work.temp_new; // ghost cell for kappa_r
+  MultiFab& temp_star = work.temp_star;
+  MultiFab& Ye_new = work.Ye_new;
+  MultiFab& Ye_star = work.Ye_star;
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -166,51 +277,39 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   }
 
   // Planck mean and Rosseland 
-  MultiFab kappa_p(grids,dmap,nGroups,1);
-  MultiFab kappa_r(grids,dmap,nGroups,1); 
+  MultiFab& kappa_p = work.kappa_p;
+  MultiFab& kappa_r = work.kappa_r;
 
   // emissivity, j_g = \int j_nu dnu
   // j_nu = 4 pi /c * \eta_0^{th} = \kappa_0 * B_\nu (assuming LTE),
   // where B_\nu is the usual Planck function \times 4 pi / c
-  MultiFab jg(grids,dmap,nGroups,1);    
-  MultiFab djdT(grids,dmap,nGroups,1);  
-  MultiFab dkdT(grids,dmap,nGroups,1);  
-  MultiFab etaT(grids,dmap,1,0);
-  MultiFab etaTz(grids,dmap,1,0);
-  MultiFab eta1(grids,dmap,1,0); // eta1 = 1 - etaT + etaY
-#ifdef NEUTRINO
-  MultiFab djdY  (grids,dmap, nGroups, 1); 
-  MultiFab dkdY  (grids,dmap, nGroups, 1); 
-  MultiFab etaY  (grids,dmap, 1      , 0);
-  MultiFab etaYz (grids,dmap, 1      , 0);
-  MultiFab thetaT(grids,dmap, 1      , 0);
-  MultiFab thetaY(grids,dmap, 1      , 0);  
-  MultiFab thetaTz(grids,dmap, 1      , 0);
-  MultiFab thetaYz(grids,dmap, 1      , 0);  
-  MultiFab theta1(grids,dmap, 1      , 0);  
-#else
-  MultiFab djdY, dkdY, etaY, etaYz, thetaT, thetaY, thetaTz, thetaYz, theta1;
-#endif
+  MultiFab& jg = work.jg;
+  MultiFab& djdT = work.djdT;
+  MultiFab& dkdT = work.dkdT;
+  MultiFab& etaT = work.etaT;
+  MultiFab& etaTz = work.etaTz;
+  MultiFab& eta1 = work.eta1; // eta1 = 1 - etaT + etaY
+  MultiFab& djdY = work.djdY;
+  MultiFab& dkdY = work.dkdY;
+  MultiFab& etaY = work.etaY;
+  MultiFab& etaYz = work.etaYz;
+  MultiFab& thetaT = work.thetaT;
+  MultiFab& thetaY = work.thetaY;
+  MultiFab& thetaTz = work.thetaTz;
+  MultiFab& thetaYz = work.thetaYz;
+  MultiFab& theta1 = work.theta1;
 
   MultiFab& mugT = djdT;
   MultiFab& mugY = djdY;
 
-  MultiFab dedT(grids,dmap,1,0);
-#ifdef NEUTRINO
-  MultiFab dedY(grids,dmap,1,0);
-#else
-  MultiFab dedY;
-#endif
+  MultiFab& dedT = work.dedT;
+  MultiFab& dedY = work.dedY;
 
-  MultiFab coupT(grids,dmap,1,0); // \sum{\kappa E - j}
-#ifdef NEUTRINO
-  MultiFab coupY(grids,dmap,1,0); // \sum{(\kappa E - j)*erg2rhoYe}
-#else 
-  MultiFab coupY;
-#endif
+  MultiFab& coupT = work.coupT; // \sum{\kappa E - j}
+  MultiFab& coupY = work.coupY; // \sum{(\kappa E - j)*erg2rhoYe}
 
   // multigroup boundary object
-  MGRadBndry mgbd(grids,dmap, nGroups, castro->Geom());
+  MGRadBndry& mgbd = *work.mgbd;
   getBndryDataMG(mgbd, Er_new, time, level);
 
   bool have_Sanchez_Pomraning = false;
@@ -224,9 +323,8 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
     }
   }
 
-  // initialize solver and boundary conditions
-  RadSolve solver(parent);
-  solver.levelInit(level);
+  // solver and boundary conditions
+  RadSolve& solver = *work.solver;
 
   Real relative_in, absolute_in, error_er;
   Real rel_rhoe, abs_rhoe;
@@ -237,20 +335,15 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
   FluxRegister* flux_in = (level < fine_level) ? flux_trial[level+1].get() : nullptr;
   FluxRegister* flux_out = (level > 0) ? flux_trial[level].get() : nullptr;
 
-  Tuple<MultiFab, BL_SPACEDIM> Flux;
-  for (int n = 0; n < BL_SPACEDIM; n++) {
-      Flux[n].define(castro->getEdgeBoxArray(n), dmap, 1, 0);
-  }
+  Tuple<MultiFab, BL_SPACEDIM>& Flux = work.Flux;
 
-  std::unique_ptr<MultiFab> flxsave;
   MultiFab* flxcc;
   int icomp_flux = -1;
   if (plot_com_flux) {
       flxcc = plotvar[level].get();
       icomp_flux = icomp_com_Fr;
   } else if (plot_lab_Er || plot_lab_flux) {
-      flxsave.reset(new MultiFab(grids, dmap, nGroups*BL_SPACEDIM, 0));
-      flxcc = flxsave.get();
+      flxcc = &work.flxsave;
       icomp_flux = 0;
   } 
 
@@ -298,12 +391,8 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
     if (limiter>0 && inner_update_limiter==0) {
       Er_star.FillBoundary(parent->Geom(level).periodicity());
 
-      for (int igroup=0; igroup<nGroups; ++igroup) {
-	scaledGradient(level, lambda, kappa_r, igroup, Er_star, igroup, limiter, 1, igroup);
-	// lambda now contains scaled gradient
-	fluxLimiter(level, lambda, limiter, igroup);
-	// lambda now contains flux limiter
-      }
+      groupFluxLimiter(level, lambda, kappa_r, Er_star, limiter);
+      // lambda now contains flux limiter
     }
     
     // djdT & djdY are both input and output
@@ -330,17 +419,25 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 	if (innerIteration <= inner_update_limiter) {
           Er_pi.FillBoundary(parent->Geom(level).periodicity());
 	  
-	  for (int igroup=0; igroup<nGroups; ++igroup) {
-	    scaledGradient(level, lambda, kappa_r, igroup, Er_pi, igroup, limiter, 1, igroup);
-	    // lambda now contains scaled gradient
-	    fluxLimiter(level, lambda, limiter, igroup);
-	    // lambda now contains flux limiter
-	  }
+	  groupFluxLimiter(level, lambda, kappa_r, Er_pi, limiter);
+	  // lambda now contains flux limiter
 	}
       }
 
       compute_coupling(coupT, coupY, kappa_p, Er_pi, jg);
 
+      // In batched mode, groups whose operator matches that of the
+      // previous group reuse its matrix and preconditioner, so only the
+      // right hand side is rebuilt for them.
+      bool batched = batch_group_solves && solver.canReuseSetup()
+	&& !have_Sanchez_Pomraning;
+      Array<int> same_op;
+      if (batched) {
+	find_shared_operators(same_op, kappa_p, kappa_r, lambda, limiter);
+      }
+
+      MultiFab& rhs = work.rhs;
+
       for (int igroup=0; igroup<nGroups; ++igroup) {
 
 	set_current_group(igroup);
@@ -349,28 +446,36 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 
 	// set boundary condition
 	solver.levelBndry(mgbd, igroup);
-	
-	solver.levelACoeffs(level, kappa_p, delta_t, c, igroup, ptc_tau);
 
-	int lamcomp = (limiter==0) ? 0 : igroup;
-	solver.levelBCoeffs(level, lambda, kappa_r, igroup, c, lamcomp);
+	if (!batched || !same_op[igroup]) {
+	  solver.levelClearSetup();
 
-	if (have_Sanchez_Pomraning) {
-	  solver.levelSPas(level, lambda, igroup, lo_bc, hi_bc);
-	}
+	  solver.levelACoeffs(level, kappa_p, delta_t, c, igroup, ptc_tau);
+
+	  int lamcomp = (limiter==0) ? 0 : igroup;
+	  solver.levelBCoeffs(level, lambda, kappa_r, igroup, c, lamcomp);
 
-	{ // src and rhd block
-	  	  
-	  MultiFab rhs(grids,dmap,1,0);
+	  if (have_Sanchez_Pomraning) {
+	    solver.levelSPas(level, lambda, igroup, lo_bc, hi_bc);
+	  }
 
-	  solver.levelRhs(level, rhs, jg, mugT, mugY, 
-			  coupT, coupY, etaT, etaY, thetaT, thetaY,
-			  Er_step, rhoe_step, rhoYe_step, Er_star, rhoe_star, rhoYe_star, 
-			  delta_t, igroup, it, ptc_tau);
+	  if (batched) {
+	    solver.levelSetup(level);
+	  }
+	}
 
-	  // solve Er equation and put solution in Er_new(igroup)
+	solver.levelRhs(level, rhs, jg, mugT, mugY, 
+			coupT, coupY, etaT, etaY, thetaT, thetaY,
+			Er_step, rhoe_step, rhoYe_step, Er_star, rhoe_star, rhoYe_star, 
+			delta_t, igroup, it, ptc_tau);
+
+	// solve Er equation and put solution in Er_new(igroup)
+	if (batched) {
+	  solver.levelSolveSetup(level, Er_new, igroup, rhs, 0.01);
+	}
+	else {
 	  solver.levelSolve(level, Er_new, igroup, rhs, 0.01);
-	} // end src and rhs block
+	}
 
 	solver.levelFlux(level, Flux, Er_new, igroup);
 	solver.levelFluxReg(level, flux_in, flux_out, Flux, igroup);
@@ -379,6 +484,8 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
 	    solver.levelFluxFaceToCenter(level, Flux, *flxcc, icomp_flux+igroup);
 
       } // end loop over groups
+
+      solver.levelClearSetup();
       
       // Check for convergence *before* acceleration step:
       check_convergence_er(relative_in, absolute_in, error_er, Er_new, Er_pi,
@@ -642,8 +749,6 @@ void Radiation::MGFLD_implicit_update(int level, int iteration, int ncycle)
     exit(1);
   }
 
-  solver.levelClear();
-
   // update flux registers
 
   flux_in = (level < fine_level) ? flux_trial[level+1].get() : nullptr;
@@ -23,7 +23,7 @@ using namespace amrex;
 Array<Real> RadSolve::absres(0);
 
 RadSolve::RadSolve(Amr* Parent) : parent(Parent),
-  hd(NULL), hm(NULL)
+  hd(NULL), hm(NULL), solver_ready(false)
 {
   ParmParse pp("radsolve");
 
@@ -502,6 +502,43 @@ void RadSolve::levelSolve(int level,
   }
 }
 
+void RadSolve::levelSetup(int level)
+{
+  BL_PROFILE("RadSolve::levelSetup");
+  BL_ASSERT(hd != NULL);
+  BL_ASSERT(!solver_ready);
+
+  hd->setScalars(alpha, beta);
+  hd->setupSolver(reltol, abstol, maxiter);
+  solver_ready = true;
+}
+
+void RadSolve::levelSolveSetup(int level,
+                               MultiFab& Er, int igroup, MultiFab& rhs,
+                               Real sync_absres_factor)
+{
+  BL_PROFILE("RadSolve::levelSolveSetup");
+  BL_ASSERT(solver_ready);
+
+  hd->solve(Er, igroup, rhs, Inhomogeneous_BC);
+  Real res = hd->getAbsoluteResidual();
+  if (verbose >= 2 && ParallelDescriptor::IOProcessor()) {
+    int oldprec = std::cout.precision(20);
+    std::cout << "Absolute residual = " << res << std::endl;
+    std::cout.precision(oldprec);
+  }
+  res *= sync_absres_factor;
+  absres[level] = (absres[level] > res) ? absres[level] : res;
+}
+
+void RadSolve::levelClearSetup()
+{
+  if (solver_ready) {
+    hd->clearSolver();
+    solver_ready = false;
+  }
+}
+
 void RadSolve::levelFluxFaceToCenter(int level, const Tuple<MultiFab, BL_SPACEDIM>& Flux,
 				     MultiFab& flx, int iflx)
 {
@@ -487,6 +487,9 @@ Radiation::Radiation(Amr* Parent, Castro* castro, int restart)
   inner_update_limiter = 0;
   pp.query("inner_update_limiter", inner_update_limiter);
 
+  batch_group_solves = 0;
+  pp.query("batch_group_solves", batch_group_solves);
+
   update_opacity    = 1000;
   
   if (SolverType == SGFLDSolver || SolverType == MGFLDSolver) {
@@ -757,6 +760,9 @@ Radiation::Radiation(Amr* Parent, Castro* castro, int restart)
 
   plotvar.resize(levels);
 
+  mgfld_work.resize(levels);
+  mgfld_work_peak = 0;
+
   delta_t_old.resize(levels, 0.0);
 
   delta_e_rat_level.resize(levels, 0.0);
@@ -814,6 +820,8 @@ void Radiation::regrid(int level, const BoxArray& grids, const DistributionMappi
       plotvar[level]->setVal(0.0);
   }
 
+  mgfld_work[level].reset();
+
   // This array will not be used on the finest level.  I create it here,
   // though, in case a finer level is created before this level is next
   // regridded:
@@ -841,6 +849,8 @@ void Radiation::close(int level)
 
     plotvar[level].reset();
 
+    mgfld_work[level].reset();
+
     if (verbose > 1 && ParallelDescriptor::IOProcessor()) {
       std::cout << "                                       done" << std::endl;
     }
@@ -2320,6 +2330,72 @@ void Radiation::fluxLimiter(int level,
   }
 }
 
+void Radiation::groupFluxLimiter(int level,
+                                 Tuple<MultiFab, BL_SPACEDIM>& lambda,
+                                 MultiFab& kappa_r, MultiFab& Er,
+                                 int limiter)
+{
+  BL_PROFILE("Radiation::groupFluxLimiter");
+  BL_ASSERT(kappa_r.nGrow() == 1);
+  BL_ASSERT(Er.nGrow() >= 1);
+  BL_ASSERT(limiter > 0 && limiter%10 != 1);
+
+  const Real* dx = parent->Geom(level).CellSize();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+      FArrayBox dtmp;
+      for (int idim = 0; idim < BL_SPACEDIM; idim++) {
+
+	  for (MFIter mfi(lambda[idim],true); mfi.isValid(); ++mfi) {
+	      const Box &nbox  = mfi.tilebox();  // note that lambda is edge based
+	      const Box& reg = amrex::enclosedCells(nbox);
+
+#if (BL_SPACEDIM >= 2)
+	      const Box& dbox = amrex::grow(reg,1);
+	      dtmp.resize(dbox, BL_SPACEDIM - 1);
+#endif
+
+	      for (int igroup = 0; igroup < nGroups; igroup++) {
+		  if (limiter%10 == 2) {
+		      scgrd2(BL_TO_FORTRAN_N(lambda[idim][mfi], igroup), 
+			     ARLIM(reg.loVect()), ARLIM(reg.hiVect()),
+			     idim, 
+			     BL_TO_FORTRAN_N(kappa_r[mfi], igroup), 
+			     Er[mfi].dataPtr(igroup),
+#if (BL_SPACEDIM >= 2)
+			     ARLIM(dbox.loVect()), ARLIM(dbox.hiVect()), dtmp.dataPtr(0), 
+#endif
+#if (BL_SPACEDIM == 3)
+			     dtmp.dataPtr(1),
+#endif
+			     dx);
+		  }
+		  else {
+		      scgrd3(BL_TO_FORTRAN_N(lambda[idim][mfi], igroup), 
+			     ARLIM(reg.loVect()), ARLIM(reg.hiVect()), 
+			     idim, 
+			     BL_TO_FORTRAN_N(kappa_r[mfi], igroup), 
+			     Er[mfi].dataPtr(igroup),
+#if (BL_SPACEDIM >= 2)
+			     ARLIM(dbox.loVect()), ARLIM(dbox.hiVect()), dtmp.dataPtr(0), 
+#endif
+#if (BL_SPACEDIM == 3)
+			     dtmp.dataPtr(1),
+#endif
+			     dx);
+		  }
+
+		  flxlim(BL_TO_FORTRAN_N(lambda[idim][mfi], igroup), 
+			 ARLIM(nbox.loVect()), ARLIM(nbox.hiVect()), limiter);
+	      }
+	  }
+      }
+  }
+}
+
 void Radiation::get_rosseland_v_dcf(MultiFab& kappa_r, MultiFab& v, MultiFab& dcf,
 				    Real delta_t, Real c,
 				    AmrLevel* castro, int igroup)
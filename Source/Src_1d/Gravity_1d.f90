@@ -69,13 +69,12 @@ contains
 
 
   subroutine ca_compute_radial_mass (lo,hi,dx,dr,&
-                                     state,r_l1,r_h1, &
+                                     rho,r_l1,r_h1, &
                                      radial_mass,radial_vol,problo, &
-                                     n1d,drdxfac,level) bind(C, name="ca_compute_radial_mass")
+                                     n1d,drdxfac,level,add_mass) bind(C, name="ca_compute_radial_mass")
 
     use bl_constants_module, only: HALF, FOUR3RD, M_PI
     use prob_params_module, only: center, Symmetry, physbc_lo, coord_type
-    use meth_params_module, only: NVAR, URHO
 
     use amrex_fort_module, only : rt => amrex_real
     implicit none
@@ -85,11 +84,12 @@ contains
     real(rt)         :: problo(1)
 
     integer          :: n1d, drdxfac, level
+    integer          :: add_mass ! if 0, only the shell volumes are accumulated
     real(rt)         :: radial_mass(0:n1d-1)
     real(rt)         :: radial_vol (0:n1d-1)
 
     integer          :: r_l1, r_h1
-    real(rt)         :: state(r_l1:r_h1,NVAR)
+    real(rt)         :: rho(r_l1:r_h1)
 
     integer          :: i, index
     integer          :: ii
@@ -143,7 +143,8 @@ contains
              index = int(r / dr)
 
              if (index .le. n1d-1) then
-                radial_mass(index) = radial_mass(index) + vol * state(i,URHO)
+                if (add_mass == 1) &
+                     radial_mass(index) = radial_mass(index) + vol * rho(i)
                 radial_vol (index) = radial_vol (index) + vol
              end if
 
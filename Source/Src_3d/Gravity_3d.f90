@@ -49,13 +49,12 @@ contains
 
 
   subroutine ca_compute_radial_mass (lo,hi,dx,dr,&
-       state,r_l1,r_l2,r_l3,r_h1,r_h2,r_h3,&
+       rho,r_l1,r_l2,r_l3,r_h1,r_h2,r_h3,&
        radial_mass,radial_vol,problo,&
-       n1d,drdxfac,level) bind(C, name="ca_compute_radial_mass")
+       n1d,drdxfac,level,add_mass) bind(C, name="ca_compute_radial_mass")
 
     use bl_constants_module
     use prob_params_module, only: center
-    use meth_params_module, only: NVAR, URHO
 
     use amrex_fort_module, only : rt => amrex_real
     implicit none
@@ -65,11 +64,12 @@ contains
     real(rt)         :: problo(3)
 
     integer          :: n1d,drdxfac,level
+    integer          :: add_mass ! if 0, only the shell volumes are accumulated
     real(rt)         :: radial_mass(0:n1d-1)
     real(rt)         :: radial_vol (0:n1d-1)
 
     integer          :: r_l1,r_l2,r_l3,r_h1,r_h2,r_h3
-    real(rt)         :: state(r_l1:r_h1,r_l2:r_h2,r_l3:r_h3,NVAR)
+    real(rt)         :: rho(r_l1:r_h1,r_l2:r_h2,r_l3:r_h3)
 
     integer          :: i,j,k,index
     integer          :: ii,jj,kk
@@ -136,7 +136,8 @@ contains
                          index = int(r*drinv)
 
                          if (index .le. n1d-1) then
-                            radial_mass(index) = radial_mass(index) + vol_frac * state(i,j,k,URHO)
+                            if (add_mass == 1) &
+                                 radial_mass(index) = radial_mass(index) + vol_frac * rho(i,j,k)
                             radial_vol (index) = radial_vol (index) + vol_frac
                          end if
                       end do
@@ -447,7 +448,7 @@ contains
                    if (l .eq. bclo(1)) then
                       locb(1) = problo(1)
                    else if (l .eq. bchi(1)) then
-                      locb(1) = probhi(2)
+                      locb(1) = probhi(1)
                    else
                       locb(1) = problo(1) + (dble(l)+HALF) * bcdx(1)
                    endif
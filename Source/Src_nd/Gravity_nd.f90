@@ -667,6 +667,189 @@ contains
 
 
 
+  subroutine ca_compute_multipole_table (lo,hi,dx, &
+                                         vol,v_lo,v_hi, &
+                                         lnum,tab,t_lo,t_hi,ncoef, &
+                                         npts) &
+                                         bind(C, name="ca_compute_multipole_table")
+
+    ! Fill tab with the geometric factor by which each zone's density
+    ! enters each of the boundary multipole moments qL0(l), qLC(l,m) and
+    ! qLS(l,m) (in that order, with m = 1..l for each l), so that the
+    ! moments are just the contraction of the table with the density.
+    ! The factors are built with the same routines that
+    ! ca_compute_multipole_moments uses, for unit density, so this only
+    ! applies to the boundary_only case.
+
+    use prob_params_module, only: problo, center, probhi, dim, coord_type
+    use bl_constants_module
+
+    use amrex_fort_module, only : rt => amrex_real
+    implicit none
+
+    integer          :: lo(3),hi(3)
+    real(rt)         :: dx(3)
+    integer          :: npts, lnum, ncoef
+
+    integer          :: v_lo(3), v_hi(3)
+    integer          :: t_lo(3), t_hi(3)
+    real(rt)         :: vol(v_lo(1):v_hi(1),v_lo(2):v_hi(2),v_lo(3):v_hi(3))
+    real(rt)         :: tab(t_lo(1):t_hi(1),t_lo(2):t_hi(2),t_lo(3):t_hi(3),0:ncoef-1)
+
+    real(rt)         :: tL0(0:lnum,0:0), tLC(0:lnum,0:lnum,0:0), tLS(0:lnum,0:lnum,0:0)
+    real(rt)         :: tU0(0:lnum,0:0), tUC(0:lnum,0:lnum,0:0), tUS(0:lnum,0:lnum,0:0)
+
+    integer          :: i, j, k, l, m, c, nlm
+    integer          :: index
+
+    real(rt)         :: x, y, z, r, drInv, cosTheta, phiAngle
+
+    if (lnum > lnum_max) then
+       call bl_error("Error: ca_compute_multipole_table: requested more multipole moments than we allocated data for.")
+    endif
+
+    nlm = (lnum * (lnum + 1)) / 2
+
+    drInv = rmax / dx(1)
+
+    do k = lo(3), hi(3)
+       z = ( problo(3) + (dble(k)+HALF) * dx(3) - center(3) ) / rmax
+
+       do j = lo(2), hi(2)
+          y = ( problo(2) + (dble(j)+HALF) * dx(2) - center(2) ) / rmax
+
+          do i = lo(1), hi(1)
+             x = ( problo(1) + (dble(i)+HALF) * dx(1) - center(1) ) / rmax
+
+             tab(i,j,k,:) = ZERO
+
+             r = sqrt( x**2 + y**2 + z**2 )
+
+             if (dim .eq. 3) then
+                index = int(r * drInv)
+                cosTheta = z / r
+                phiAngle = atan2(y, x)
+             else if (dim .eq. 2 .and. coord_type .eq. 1) then
+                index = npts-1
+                cosTheta = y / r
+                phiAngle = z
+             endif
+
+             ! Zones outside the outermost bin only contribute to the
+             ! upper moments, which the boundary values do not use.
+
+             if (index > npts-1) cycle
+
+             tL0 = ZERO
+             tLC = ZERO
+             tLS = ZERO
+             tU0 = ZERO
+             tUC = ZERO
+             tUS = ZERO
+
+             call multipole_add(cosTheta, phiAngle, r, ONE, vol(i,j,k) / rmax**3, &
+                                tL0, tLC, tLS, tU0, tUC, tUS, lnum, 1, 0, 0, .true.)
+
+             if ( doSymmetricAdd ) then
+
+                call multipole_symmetric_add(doSymmetricAddLo, doSymmetricAddHi, &
+                                             x, y, z, problo, probhi, &
+                                             ONE, vol(i,j,k) / rmax**3, &
+                                             tL0, tLC, tLS, tU0, tUC, tUS, &
+                                             lnum, 1, 0, 0)
+
+             endif
+
+             do l = 0, lnum
+                tab(i,j,k,l) = tL0(l,0)
+             enddo
+
+             c = lnum + 1
+
+             do l = 1, lnum
+                do m = 1, l
+                   tab(i,j,k,c    ) = tLC(l,m,0)
+                   tab(i,j,k,c+nlm) = tLS(l,m,0)
+                   c = c + 1
+                enddo
+             enddo
+
+          enddo
+       enddo
+    enddo
+
+  end subroutine ca_compute_multipole_table
+
+
+
+  subroutine ca_multipole_table_moments (lo,hi, &
+                                         rho,r_lo,r_hi, &
+                                         tab,t_lo,t_hi,ncoef, &
+                                         lnum,qL0,qLC,qLS,npts) &
+                                         bind(C, name="ca_multipole_table_moments")
+
+    ! Add the boundary multipole moments of rho over the box to the
+    ! outermost bin of qL0, qLC and qLS, using the geometric factors
+    ! from ca_compute_multipole_table.
+
+    use bl_constants_module
+
+    use amrex_fort_module, only : rt => amrex_real
+    implicit none
+
+    integer          :: lo(3),hi(3)
+    integer          :: npts, lnum, ncoef
+
+    real(rt)         :: qL0(0:lnum,0:npts-1), qLC(0:lnum,0:lnum,0:npts-1), qLS(0:lnum,0:lnum,0:npts-1)
+
+    integer          :: r_lo(3), r_hi(3)
+    integer          :: t_lo(3), t_hi(3)
+    real(rt)         :: rho(r_lo(1):r_hi(1),r_lo(2):r_hi(2),r_lo(3):r_hi(3))
+    real(rt)         :: tab(t_lo(1):t_hi(1),t_lo(2):t_hi(2),t_lo(3):t_hi(3),0:ncoef-1)
+
+    integer          :: i, j, k, l, m, c, n, nlm
+    real(rt)         :: moment(0:ncoef-1), msum
+
+    ! Each moment is a dense, unit-stride dot product of the density
+    ! with one component of the table.
+
+    do c = 0, ncoef-1
+
+       msum = ZERO
+
+       do k = lo(3), hi(3)
+          do j = lo(2), hi(2)
+             do i = lo(1), hi(1)
+                msum = msum + rho(i,j,k) * tab(i,j,k,c)
+             enddo
+          enddo
+       enddo
+
+       moment(c) = msum
+
+    enddo
+
+    n = npts - 1
+    nlm = (lnum * (lnum + 1)) / 2
+
+    do l = 0, lnum
+       qL0(l,n) = qL0(l,n) + moment(l)
+    enddo
+
+    c = lnum + 1
+
+    do l = 1, lnum
+       do m = 1, l
+          qLC(l,m,n) = qLC(l,m,n) + moment(c)
+          qLS(l,m,n) = qLS(l,m,n) + moment(c+nlm)
+          c = c + 1
+       enddo
+    enddo
+
+  end subroutine ca_multipole_table_moments
+
+
+
   function factorial(n)
 
     use bl_constants_module
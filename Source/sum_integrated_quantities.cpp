@@ -38,38 +38,78 @@ Castro::sum_integrated_quantities ()
     int datwidth     = 14;
     int datprecision = 6;
 
+    // All of the quantities are evaluated together in one sweep per level.
+
+    Array<IntegralSpec> integrals;
+
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "density"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "xmom"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "ymom"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "zmom"));
+
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "angular_momentum_x"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "angular_momentum_y"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "angular_momentum_z"));
+
+#ifdef HYBRID_MOMENTUM
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "rmom"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "lmom"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "zmom"));
+#endif
+
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "rho_e"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "kineng"));
+    integrals.push_back(IntegralSpec(vol_wgt_sum, "rho_E"));
+#ifdef SELF_GRAVITY
+    integrals.push_back(IntegralSpec("density", "phiGrav"));
+#endif
+
+    const int com_start = integrals.size();
+
+    if (show_center_of_mass) {
+        integrals.push_back(IntegralSpec(loc_wgt_sum, "density", 0));
+        integrals.push_back(IntegralSpec(loc_wgt_sum, "density", 1));
+        integrals.push_back(IntegralSpec(loc_wgt_sum, "density", 2));
+    }
+
+    Array<Real> sums;
+
     for (int lev = 0; lev <= finest_level; lev++)
     {
         Castro& ca_lev = getLevel(lev);
 
-        mass   += ca_lev.volWgtSum("density", time, local_flag);
-        mom[0] += ca_lev.volWgtSum("xmom", time, local_flag);
-	mom[1] += ca_lev.volWgtSum("ymom", time, local_flag);
-	mom[2] += ca_lev.volWgtSum("zmom", time, local_flag);
+        ca_lev.sumIntegrals(integrals, time, sums, local_flag);
+
+        int i = 0;
 
-	ang_mom[0] += ca_lev.volWgtSum("angular_momentum_x", time, local_flag);
-	ang_mom[1] += ca_lev.volWgtSum("angular_momentum_y", time, local_flag);
-	ang_mom[2] += ca_lev.volWgtSum("angular_momentum_z", time, local_flag);
+        mass       += sums[i++];
+        mom[0]     += sums[i++];
+        mom[1]     += sums[i++];
+        mom[2]     += sums[i++];
+
+        ang_mom[0] += sums[i++];
+        ang_mom[1] += sums[i++];
+        ang_mom[2] += sums[i++];
 
 #ifdef HYBRID_MOMENTUM
-	hyb_mom[0] += ca_lev.volWgtSum("rmom", time, local_flag);
-	hyb_mom[1] += ca_lev.volWgtSum("lmom", time, local_flag);
-	hyb_mom[2] += ca_lev.volWgtSum("zmom", time, local_flag);
-#endif
-	
-	if (show_center_of_mass) {
-	   com[0] += ca_lev.locWgtSum("density", time, 0, local_flag);
-	   com[1] += ca_lev.locWgtSum("density", time, 1, local_flag);
-	   com[2] += ca_lev.locWgtSum("density", time, 2, local_flag);
-	}
+        hyb_mom[0] += sums[i++];
+        hyb_mom[1] += sums[i++];
+        hyb_mom[2] += sums[i++];
+#endif
 
-       rho_e += ca_lev.volWgtSum("rho_e", time, local_flag);
-       rho_K += ca_lev.volWgtSum("kineng", time, local_flag);
-       rho_E += ca_lev.volWgtSum("rho_E", time, local_flag);
+        rho_e      += sums[i++];
+        rho_K      += sums[i++];
+        rho_E      += sums[i++];
 #ifdef SELF_GRAVITY
-       rho_phi += ca_lev.volProductSum("density", "phiGrav", time, local_flag);
+        rho_phi    += sums[i++];
 #endif
 
+        if (show_center_of_mass) {
+            com[0] += sums[com_start];
+            com[1] += sums[com_start+1];
+            com[2] += sums[com_start+2];
+        }
+
     }
  
     if (verbose > 0)
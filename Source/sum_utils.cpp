@@ -1,4 +1,5 @@
 #include <iomanip>
+#include <algorithm>
 
 #include <Castro.H>
 #include <Castro_F.H>
@@ -10,6 +11,24 @@
 
 using namespace amrex;
 
+// The half of the domain on side 0 (lo) or 1 (hi) of the midpoint in
+// direction bdir, as used by the one-sided sums.
+
+static Box
+domain_half (const Box& domain, int side, int bdir)
+{
+    Box half = domain;
+
+    const int mid = domain.bigEnd(bdir) / 2;
+
+    if (side == 0)
+	half.setBig(bdir, mid);
+    else
+	half.setSmall(bdir, mid + 1);
+
+    return half;
+}
+
 Real
 Castro::sumDerive (const std::string& name,
                    Real               time,
@@ -21,18 +40,20 @@ Castro::sumDerive (const std::string& name,
     BL_ASSERT(mf);
 
     if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
+	getLevel(level+1).build_fine_mask_boxes();
 
 #ifdef _OPENMP
 #pragma omp parallel reduction(+:sum)
 #endif
     {
+	std::vector<Box> boxes;
+
 	for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
 	{
-	    sum += (*mf)[mfi].sum(mfi.tilebox(),0);
+	    fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), boxes);
+
+	    for (int ib = 0; ib < boxes.size(); ++ib)
+		sum += (*mf)[mfi].sum(boxes[ib],0);
 	}
     }
 
@@ -42,53 +63,148 @@ Castro::sumDerive (const std::string& name,
     return sum;
 }
 
-Real
-Castro::volWgtSum (const std::string& name,
-                   Real               time,
-		   bool               local,
-		   bool               finemask)
+void
+Castro::sumIntegrals (const Array<IntegralSpec>& integrals,
+                      Real                       time,
+                      Array<Real>&               sums,
+                      bool                       local,
+                      bool                       finemask)
 {
-    BL_PROFILE("Castro::volWgtSum()");
+    BL_PROFILE("Castro::sumIntegrals()");
 
-    Real        sum     = 0.0;
-    const Real* dx      = geom.CellSize();
-    auto mf = derive(name,time,0);
+    const int nint = integrals.size();
 
-    BL_ASSERT(mf);
+    sums.resize(nint);
+    for (int n = 0; n < nint; ++n)
+        sums[n] = 0.0;
+
+    if (nint == 0) return;
+
+    const Real* dx = geom.CellSize();
 
-    if (level < parent->finestLevel() && finemask)
+    // Derive each distinct quantity once into its own component.
+
+    std::vector<std::string> names;
+    Array<int> comp1(nint), comp2(nint);
+
+    for (int n = 0; n < nint; ++n)
     {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
+        const int nfields = integrals[n].type == vol_product_sum ? 2 : 1;
+
+        for (int f = 0; f < nfields; ++f)
+        {
+            const std::string& name = f == 0 ? integrals[n].name : integrals[n].name2;
+
+            int c = std::find(names.begin(), names.end(), name) - names.begin();
+            if (c == static_cast<int>(names.size()))
+                names.push_back(name);
+
+            if (f == 0)
+                comp1[n] = c;
+            else
+                comp2[n] = c;
+        }
     }
 
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:sum)
-#endif    
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
-    {
-        FArrayBox& fab = (*mf)[mfi];
+    MultiFab mf(grids, dmap, names.size(), 0);
 
-	Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
+    for (int c = 0; c < names.size(); ++c)
+        derive(names[c], time, mf, c);
 
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        //
+    // Zones covered by the next finer level are skipped by visiting
+    // only the uncovered parts of each tile.
 
-	ca_summass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
-		   ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s);
+    const bool masked = level < parent->finestLevel() && finemask;
 
-        sum += s;
+    if (masked)
+	getLevel(level+1).build_fine_mask_boxes();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Array<Real> priv_sums(nint, 0.0);
+        std::vector<Box> boxes;
+
+        for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+        {
+            FArrayBox& fab  = mf[mfi];
+            FArrayBox& vfab = volume[mfi];
+
+            fine_mask_tile_boxes(mfi.index(), mfi.tilebox(), boxes, 0, finemask);
+
+            for (int ib = 0; ib < boxes.size(); ++ib)
+            {
+                const Box& box  = boxes[ib];
+                const int* lo   = box.loVect();
+                const int* hi   = box.hiVect();
+
+                for (int n = 0; n < nint; ++n)
+                {
+                    const IntegralSpec& q = integrals[n];
+
+                    Real s = 0.0;
+
+                    switch (q.type)
+                    {
+                    case vol_wgt_sum:
+                        ca_summass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_N_3D(fab,comp1[n]),
+                                   ZFILL(dx),BL_TO_FORTRAN_3D(vfab),&s);
+                        break;
+                    case vol_wgt_squared_sum:
+                        ca_sumsquared(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_N_3D(fab,comp1[n]),
+                                      ZFILL(dx),BL_TO_FORTRAN_3D(vfab),&s);
+                        break;
+                    case loc_wgt_sum:
+                        ca_sumlocmass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_N_3D(fab,comp1[n]),
+                                      ZFILL(dx),BL_TO_FORTRAN_3D(vfab),&s,q.idir);
+                        break;
+                    case loc_wgt_sum_2d:
+                        ca_sumlocmass2d(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_N_3D(fab,comp1[n]),
+                                        ZFILL(dx),BL_TO_FORTRAN_3D(vfab),&s,q.idir,q.idir2);
+                        break;
+                    case loc_squared_sum:
+                        ca_sumlocsquaredmass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_N_3D(fab,comp1[n]),
+                                             ZFILL(dx),BL_TO_FORTRAN_3D(vfab),&s,q.idir);
+                        break;
+                    case vol_product_sum:
+                        ca_sumproduct(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_N_3D(fab,comp1[n]),
+                                      BL_TO_FORTRAN_N_3D(fab,comp2[n]),ZFILL(dx),BL_TO_FORTRAN_3D(vfab),&s);
+                        break;
+                    default:
+                        amrex::Abort("Castro::sumIntegrals: unknown integral type");
+                    }
+
+                    priv_sums[n] += s;
+                }
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp critical (castro_sum_integrals)
+#endif
+        for (int n = 0; n < nint; ++n)
+            sums[n] += priv_sums[n];
     }
 
     if (!local)
-	ParallelDescriptor::ReduceRealSum(sum);
+	ParallelDescriptor::ReduceRealSum(sums.dataPtr(), nint);
+}
 
-    return sum;
+Real
+Castro::volWgtSum (const std::string& name,
+                   Real               time,
+		   bool               local,
+		   bool               finemask)
+{
+    BL_PROFILE("Castro::volWgtSum()");
+
+    Array<IntegralSpec> integrals(1, IntegralSpec(vol_wgt_sum, name));
+    Array<Real> sums;
+
+    sumIntegrals(integrals, time, sums, local, finemask);
+
+    return sums[0];
 }
 
 Real
@@ -98,45 +214,12 @@ Castro::volWgtSquaredSum (const std::string& name,
 {
     BL_PROFILE("Castro::volWgtSquaredSum()");
 
-    Real        sum     = 0.0;
-    const Real* dx      = geom.CellSize();
-    auto mf = derive(name,time,0);
-
-    BL_ASSERT(mf);
-
-    if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
-
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:sum)
-#endif    
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
-    {
-        FArrayBox& fab = (*mf)[mfi];
-    
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
-
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        //
-
-	ca_sumsquared(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
-		      ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s);
-
-        sum += s;
-    }
+    Array<IntegralSpec> integrals(1, IntegralSpec(vol_wgt_squared_sum, name));
+    Array<Real> sums;
 
-    if (!local)
-	ParallelDescriptor::ReduceRealSum(sum);
+    sumIntegrals(integrals, time, sums, local);
 
-    return sum;
+    return sums[0];
 }
 
 Real
@@ -147,45 +230,12 @@ Castro::locWgtSum (const std::string& name,
 {
     BL_PROFILE("Castro::locWgtSum()");
 
-    Real        sum     = 0.0;
-    const Real* dx      = geom.CellSize();
-    auto mf = derive(name,time,0);
-
-    BL_ASSERT(mf);
+    Array<IntegralSpec> integrals(1, IntegralSpec(loc_wgt_sum, name, idir));
+    Array<Real> sums;
 
-    if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
-
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:sum)
-#endif    
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
-    {
-        FArrayBox& fab = (*mf)[mfi];
-    
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
-
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        //
-
-	ca_sumlocmass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
-		      ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s,idir);
-
-        sum += s;
-    }
+    sumIntegrals(integrals, time, sums, local);
 
-    if (!local)
-	ParallelDescriptor::ReduceRealSum(sum);
-
-    return sum;
+    return sums[0];
 }
 
 Real
@@ -197,45 +247,12 @@ Castro::locWgtSum2D (const std::string& name,
 {
     BL_PROFILE("Castro::locWgtSum2D()");
 
-    Real        sum     = 0.0;
-    const Real* dx      = geom.CellSize();
-    auto mf = derive(name,time,0);
-
-    BL_ASSERT(mf);
-
-    if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
-
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:sum)
-#endif    
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
-    {
-        FArrayBox& fab = (*mf)[mfi];
-    
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
-
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        //
-
-	ca_sumlocmass2d(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
-			ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s,idir1,idir2);
-
-        sum += s;
-    }
+    Array<IntegralSpec> integrals(1, IntegralSpec(loc_wgt_sum_2d, name, idir1, idir2));
+    Array<Real> sums;
 
-    if (!local)
-	ParallelDescriptor::ReduceRealSum(sum);
+    sumIntegrals(integrals, time, sums, local);
 
-    return sum;
+    return sums[0];
 }
 
 Real
@@ -292,77 +309,49 @@ Castro::volWgtSumOneSide (const std::string& name,
     Real        sum     = 0.0;
     const Real* dx      = geom.CellSize();
     auto        mf      = derive(name,time,0);
-    const int* domhi    = geom.Domain().hiVect();
 
     BL_ASSERT(mf);
 
+    const Box half = domain_half(geom.Domain(), side, bdir);
+
     if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
+	getLevel(level+1).build_fine_mask_boxes();
 
 #ifdef _OPENMP
 #pragma omp parallel reduction(+:sum)
 #endif    
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
     {
-        FArrayBox& fab = (*mf)[mfi];
-    
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
+	std::vector<Box> boxes;
 
-        int hiLeft[3]       = { *hi, *(hi+1), *(hi+2) };
-        int loRight[3]      = { *lo, *(lo+1), *(lo+2) };
+	for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
+	{
+	    const Box tbx = mfi.tilebox() & half;
 
-        hiLeft[bdir]        = *(domhi+bdir) / 2;
-        loRight[bdir]       = *(domhi+bdir) / 2 + 1;
+	    if (!tbx.ok()) continue;
 
-        const int* hiLeftPtr  = hiLeft;
-        const int* loRightPtr = loRight;
-        const int* loFinal;
-        const int* hiFinal;
+	    FArrayBox& fab = (*mf)[mfi];
 
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        //
-        
-        bool doSum = false;
-        if ( side == 0 && *(lo + bdir) <= *(hiLeftPtr + bdir) ) {
-          doSum = true;
-          if ( *(hi + bdir) <= *(hiLeftPtr + bdir) ) {
-            loFinal   = lo;
-            hiFinal   = hi;
-	  }
-	  else {
-            loFinal   = lo;
-            hiFinal   = hiLeftPtr;
-	  }
-	}  
-        else if ( side == 1 && *(hi + bdir) >= *(loRightPtr + bdir) ) {
-          doSum = true;
-          if ( *(lo + bdir) >= *(loRightPtr + bdir) ) {
-            loFinal   = lo;
-            hiFinal   = hi;
-          }
-          else {
-            loFinal   = loRightPtr;
-            hiFinal   = hi;
-          }
-	}
+	    // Zones covered by the finer level are skipped.
 
-        if ( doSum ) {
+	    fine_mask_tile_boxes(mfi.index(), tbx, boxes);
 
-          ca_summass(ARLIM_3D(loFinal),ARLIM_3D(hiFinal),BL_TO_FORTRAN_3D(fab),
-		     ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s);
+	    for (int ib = 0; ib < boxes.size(); ++ib)
+	    {
+		Real s = 0.0;
+		const int* lo = boxes[ib].loVect();
+		const int* hi = boxes[ib].hiVect();
 
-        }
-        
-        sum += s;
-		
+		//
+		// Note that this routine will do a volume weighted sum of
+		// whatever quantity is passed in, not strictly the "mass".
+		//
+
+		ca_summass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
+			   ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s);
+
+		sum += s;
+	    }
+	}
     }
 
     if (!local)
@@ -389,76 +378,49 @@ Castro::locWgtSumOneSide (const std::string& name,
     Real sum            = 0.0;
     const Real* dx      = geom.CellSize();
     auto        mf      = derive(name,time,0); 
-    const int* domhi    = geom.Domain().hiVect(); 
 
     BL_ASSERT(mf);
 
+    const Box half = domain_half(geom.Domain(), side, bdir);
+
     if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
+	getLevel(level+1).build_fine_mask_boxes();
 
 #ifdef _OPENMP
 #pragma omp parallel reduction(+:sum)
 #endif        
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
     {
-        FArrayBox& fab = (*mf)[mfi];
+	std::vector<Box> boxes;
 
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
+	for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
+	{
+	    const Box tbx = mfi.tilebox() & half;
 
-        int hiLeft[3]       = { *hi, *(hi+1), *(hi+2) };
-        int loRight[3]      = { *lo, *(lo+1), *(lo+2) };
+	    if (!tbx.ok()) continue;
 
-        hiLeft[bdir]        = *(domhi+bdir) / 2;
-        loRight[bdir]       = (*(domhi+bdir) / 2) + 1;
+	    FArrayBox& fab = (*mf)[mfi];
 
-        const int* hiLeftPtr  = hiLeft;
-        const int* loRightPtr = loRight;
-        const int* loFinal;
-        const int* hiFinal;        
-        //
-        // Note that this routine will do a volume weighted sum of
-        // whatever quantity is passed in, not strictly the "mass".
-        // 
-
-        bool doSum = false;
-        if ( side == 0 && *(lo + bdir) <= *(hiLeftPtr + bdir) ) {
-          doSum = true;
-          if ( *(hi + bdir) <= *(hiLeftPtr + bdir) ) {
-            loFinal   = box.loVect();
-            hiFinal   = box.hiVect();
-	  }
-	  else {
-            loFinal   = box.loVect();
-            hiFinal   = hiLeftPtr;
-	  }
-	}  
-        else if ( side == 1 && *(hi + bdir) >= *(loRightPtr + bdir) ) {
-          doSum = true;
-          if ( *(lo + bdir) >= *(loRightPtr + bdir) ) {
-            loFinal   = box.loVect();
-            hiFinal   = box.hiVect();
-          }
-          else {
-            loFinal   = loRightPtr;
-            hiFinal   = box.hiVect();
-          }
-	}
+	    // Zones covered by the finer level are skipped.
 
-        if ( doSum ) {
+	    fine_mask_tile_boxes(mfi.index(), tbx, boxes);
 
-          ca_sumlocmass(ARLIM_3D(loFinal),ARLIM_3D(hiFinal),BL_TO_FORTRAN_3D(fab),
-			ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s,idir);
+	    for (int ib = 0; ib < boxes.size(); ++ib)
+	    {
+		Real s = 0.0;
+		const int* lo = boxes[ib].loVect();
+		const int* hi = boxes[ib].hiVect();
 
-        }
-     
-        sum += s;
-        
+		//
+		// Note that this routine will do a volume weighted sum of
+		// whatever quantity is passed in, not strictly the "mass".
+		//
+
+		ca_sumlocmass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
+			      ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s,idir);
+
+		sum += s;
+	    }
+	}
     }
 
     if (!local)
@@ -475,44 +437,12 @@ Castro::volProductSum (const std::string& name1,
 {
     BL_PROFILE("Castro::volProductSum()");
 
-    Real        sum = 0.0;
-    const Real* dx  = geom.CellSize();
-    auto        mf1 = derive(name1,time,0);
-    auto        mf2 = derive(name2,time,0);
+    Array<IntegralSpec> integrals(1, IntegralSpec(name1, name2));
+    Array<Real> sums;
 
-    BL_ASSERT(mf1);
-    BL_ASSERT(mf2);
+    sumIntegrals(integrals, time, sums, local);
 
-    if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf1, mask, 0, 0, 1, 0);
-	MultiFab::Multiply(*mf2, mask, 0, 0, 1, 0);
-    }
-
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:sum)
-#endif    
-    for (MFIter mfi(*mf1,true); mfi.isValid(); ++mfi)
-    {
-        FArrayBox& fab1 = (*mf1)[mfi];
-        FArrayBox& fab2 = (*mf2)[mfi];
-    
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
-
-	ca_sumproduct(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab1),
-		      BL_TO_FORTRAN_3D(fab2),ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s);
-        
-        sum += s;
-    }
-
-    if (!local)
-	ParallelDescriptor::ReduceRealSum(sum);
-
-    return sum;
+    return sums[0];
 }
 
 Real
@@ -523,39 +453,11 @@ Castro::locSquaredSum (const std::string& name,
 {
     BL_PROFILE("Castro::locSquaredSum()");
 
-    Real        sum     = 0.0;
-    const Real* dx      = geom.CellSize();
-    auto        mf      = derive(name,time,0);
-
-    BL_ASSERT(mf);
-
-    if (level < parent->finestLevel())
-    {
-	const MultiFab& mask = getLevel(level+1).build_fine_mask();
-	MultiFab::Multiply(*mf, mask, 0, 0, 1, 0);
-    }
-
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:sum)
-#endif    
-    for (MFIter mfi(*mf,true); mfi.isValid(); ++mfi)
-    {
-        FArrayBox& fab = (*mf)[mfi];
-    
-        Real s = 0.0;
-        const Box& box  = mfi.tilebox();
-        const int* lo   = box.loVect();
-        const int* hi   = box.hiVect();
-
-	ca_sumlocsquaredmass(ARLIM_3D(lo),ARLIM_3D(hi),BL_TO_FORTRAN_3D(fab),
-			     ZFILL(dx),BL_TO_FORTRAN_3D(volume[mfi]),&s,idir);
+    Array<IntegralSpec> integrals(1, IntegralSpec(loc_squared_sum, name, idir));
+    Array<Real> sums;
 
-        sum += s;
-    }
+    sumIntegrals(integrals, time, sums, local);
 
-    if (!local)
-	ParallelDescriptor::ReduceRealSum(sum);
-
-    return sum;
+    return sums[0];
 }
 